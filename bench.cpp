@@ -0,0 +1,1020 @@
+/*
+ Benchmarks hors CPLEX.
+
+ Utilisation :
+    bench load <break.json> [replication]
+        Compare le chargement DOM (json::parse) et le chargement SAX du fichier
+        des écrans. Avec replication > 1, les écrans sont recopiés pour
+        produire un fichier de replication * m écrans.
+
+    bench grp <break.json> <brands.json> <replication> <copies_marques>
+        Mesure la construction de la matrice grp_ij sur replication * m écrans
+        et copies_marques * n marques.
+
+    bench formats <break.json> <brands.json> [replication]
+        Convertit les écrans et les marques en CBOR, MessagePack et BSON puis
+        mesure le débit de chargement de chaque format.
+
+    bench scale <break.json> <brands.json> <replication> <copies_marques> <prefixe>
+        Ecrit une instance agrandie (<prefixe>_breaks.json, <prefixe>_brands.json)
+        pour la résoudre avec le programme principal, et compte les contraintes
+        de marques concurrentes des deux formulations.
+
+    bench cache <break.json> <brands.json> <cache>
+        Compare la lecture des JSON et le rechargement du cache binaire.
+
+    bench greedy <break.json> <brands.json> <replication> <copies_marques>
+        Mesure les allocations gloutonnes (GRP/s et revenu/s) sur
+        replication * m écrans et copies_marques * n marques.
+
+    bench search <break.json> <brands.json> <replication> <copies_marques> <secondes> [threads]
+        Améliore les allocations gloutonnes par recherche locale pendant
+        <secondes> (GRP pour le glouton GRP/s, revenu pour le glouton revenu/s).
+
+    bench knapsack <break.json> <brands.json> <replication> [copies_marques]
+        Résout le sac à dos de chacun des replication * m écrans (profit
+        grp_ij, par exemple 25000 pour 1M d'écrans avec break.json) avec la
+        boucle scalaire puis le noyau vectorisé, et vérifie que les valeurs
+        sont identiques.
+
+    bench front <break.json> <brands.json> <ecrans> <intervalles> [intervalles ...]
+        Sur les <ecrans> premiers écrans, vérifie que l'exploration parallèle
+        du front (2 résolutions simultanées, chaque nombre d'intervalles
+        donné) trouve le même front que la boucle d'epsilon séquentielle.
+
+    bench check <break.json> <brands.json> <ecrans>
+        Vérifications de comportement sur les <ecrans> premiers écrans (une
+        quinzaine : le modèle sans presolve est aussi résolu). Pour le revenu
+        TV et le GRP, contre l'optimum du modèle exact (solveur natif) :
+          - allocations gloutonnes réalisables, pas meilleures que l'optimum ;
+          - borne lagrangienne au moins égale à l'optimum ;
+          - génération de colonnes réalisable, pas meilleure que l'optimum,
+            bornes (maître complet, lagrangienne) au moins égales ;
+          - presolve sans effet sur l'optimum (budgets de l'instance et
+            serrés), allocation reconstruite réalisable ;
+          - agrégation (écrans recopiés 3 fois) sans effet sur l'optimum,
+            comptes répartis en une allocation réalisable ;
+          - décomposition par station réalisable (budgets globaux), entre
+            son départ glouton et l'optimum ;
+          - horizon glissant réalisable (budgets globaux), pas meilleur que
+            l'optimum ;
+        Puis, indépendamment de l'objectif :
+          - sac à dos de chaque écran égal à l'énumération de tous les
+            ensembles de marques ;
+          - archive de Pareto égale au filtrage deux à deux de points tirés
+            au hasard (2 et 4 objectifs), et relue à l'identique ;
+        Chaque vérification affiche ok ou ERREUR ; le code de sortie est
+        non nul si l'une échoue.
+
+ Les fichiers intermédiaires (écrans recopiés, conversions, fronts) sont
+ écrits dans un dossier temporaire retiré à la fin du benchmark.
+ */
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <filesystem>
+#include <stdexcept>
+#include <string.h>
+#include <sys/resource.h>
+#include "json.hpp"
+#include "loader.h"
+#include "cache.h"
+#include "colgen.h"
+#include "decomposition.h"
+#include "heuristic.h"
+#include "local_search.h"
+#include "knapsack.h"
+#include "lagrangian.h"
+#include "model.h"
+#include "native_backend.h"
+#include "pareto.h"
+#include "presolve.h"
+#include "rolling.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+
+// Pic de mémoire résidente du processus, en Mo
+static double peak_rss_mb()
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+#ifdef __APPLE__
+    return ru.ru_maxrss / (1024.0 * 1024.0);
+#else
+    return ru.ru_maxrss / 1024.0;
+#endif
+}
+
+static double seconds_since(chrono::steady_clock::time_point t0)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+// Dossier temporaire vide, retiré avec son contenu à la destruction : les
+// fichiers produits par les benchmarks ne restent pas à côté des sources
+struct Temp_Dir {
+    string path;
+
+    Temp_Dir() : path((filesystem::temp_directory_path() / "spots_bench_XXXXXX").string())
+    {
+        if (!mkdtemp(&path[0])){
+            throw runtime_error("Impossible de creer un dossier temporaire");
+        }
+    }
+
+    ~Temp_Dir()
+    {
+        error_code ec;
+        filesystem::remove_all(path, ec);
+    }
+
+    Temp_Dir(const Temp_Dir&) = delete;
+    Temp_Dir& operator=(const Temp_Dir&) = delete;
+
+    // Chemin du fichier "name" dans le dossier
+    string file(const string& name) const { return (filesystem::path(path) / name).string(); }
+};
+
+// Ecrit dans dir un fichier contenant "replication" copies des écrans de "path"
+static string replicate_breaks(const string& path, int replication, const Temp_Dir& dir)
+{
+    ifstream bks(path);
+    json breaks = json::parse(bks);
+    int m = (int) breaks.size();
+
+    string out_path = dir.file(filesystem::path(path).stem().string() + ".x" + to_string(replication) + ".json");
+    ofstream out(out_path);
+    out << "{";
+    int cpt = 0;
+    for (int r = 0; r < replication; r++){
+        for (const auto& item : breaks.items()){
+            out << (cpt ? ",\n" : "\n") << '"' << (r * m + stoi(item.key())) << "\": " << item.value().dump();
+            cpt++;
+        }
+    }
+    out << "\n}\n";
+    return out_path;
+}
+
+template <typename T>
+static bool same_column(const Column<T>& a, const Column<T>& b)
+{
+    return a.size() == b.size() && equal(a.begin(), a.end(), b.begin());
+}
+
+// Le DOM parcourt les clés triées, le SAX dans l'ordre du fichier : les
+// audiences sont comparées par nom
+static bool same_data(const Instance& a, const Instance& b)
+{
+    if (a.nb_Com_Break != b.nb_Com_Break || a.nb_Audiences() != b.nb_Audiences()
+        || !same_column(a.break_time, b.break_time) || !same_column(a.prime_break, b.prime_break)
+        || !same_column(a.station, b.station) || !same_column(a.start_date, b.start_date)
+        || !same_column(a.delay, b.delay)){
+        return false;
+    }
+    for (int s = 0; s < NB_SLOTS; s++){
+        if (!same_column(a.slot_price[s], b.slot_price[s]) || !same_column(a.slot_available[s], b.slot_available[s])){
+            return false;
+        }
+    }
+    for (int ka = 0; ka < a.nb_Audiences(); ka++){
+        int kb = b.audience_index(a.audiences.names[ka]);
+        if (kb < 0 || !same_column(a.grp[ka], b.grp[kb])){
+            return false;
+        }
+    }
+    return true;
+}
+
+static int bench_load(const string& path, int replication)
+{
+    Temp_Dir dir;
+    string file = replication > 1 ? replicate_breaks(path, replication, dir) : path;
+    ifstream f(file, ios::binary | ios::ate);
+    double size_mb = f.tellg() / (1024.0 * 1024.0);
+    cout << "Fichier : " << file << " (" << size_mb << " Mo)" << endl;
+
+    // SAX en premier : le pic mémoire mesuré ensuite inclut celui du DOM
+    double rss0 = peak_rss_mb();
+    auto t0 = chrono::steady_clock::now();
+    Instance sax;
+    load_breaks_sax(file, sax);
+    double t_sax = seconds_since(t0);
+    double rss_sax = peak_rss_mb();
+
+    t0 = chrono::steady_clock::now();
+    Instance dom;
+    load_breaks_dom(file, dom);
+    double t_dom = seconds_since(t0);
+    double rss_dom = peak_rss_mb();
+
+    cout << "Nombre de spots : " << sax.nb_Com_Break << endl;
+    cout << "SAX : " << t_sax << " s, " << size_mb / t_sax << " Mo/s, pic memoire +" << rss_sax - rss0 << " Mo" << endl;
+    cout << "DOM : " << t_dom << " s, " << size_mb / t_dom << " Mo/s, pic memoire +" << rss_dom - rss_sax << " Mo" << endl;
+
+    if (!same_data(sax, dom)){
+        cerr << "ERREUR : les chargements SAX et DOM different" << endl;
+        return 1;
+    }
+    cout << "Donnees identiques" << endl;
+    return 0;
+}
+
+// Recopie les écrans et les marques d'une instance déjà chargée
+static Instance replicate_instance(const Instance& base, int replication, int brand_copies)
+{
+    Instance inst;
+    inst.audiences = base.audiences;
+    inst.types = base.types;
+    inst.grp.resize(base.grp.size());
+    inst.reserve_break(base.nb_Com_Break * replication - 1);
+    for (int i = 0; i < inst.nb_Com_Break; i++){
+        int i0 = i % base.nb_Com_Break;
+        inst.break_time[i] = base.break_time[i0];
+        inst.prime_break[i] = base.prime_break[i0];
+        inst.station[i] = base.station[i0];
+        inst.start_date[i] = base.start_date[i0];
+        inst.delay[i] = base.delay[i0];
+        for (int a = 0; a < inst.nb_Audiences(); a++){
+            inst.grp[a][i] = base.grp[a][i0];
+        }
+        for (int s = 0; s < NB_SLOTS; s++){
+            inst.slot_price[s][i] = base.slot_price[s][i0];
+            inst.slot_available[s][i] = base.slot_available[s][i0];
+        }
+    }
+    inst.reserve_brand(base.nb_Brands * brand_copies - 1);
+    for (int j = 0; j < inst.nb_Brands; j++){
+        int j0 = j % base.nb_Brands;
+        inst.brand_type[j] = base.brand_type[j0];
+        inst.brand_audience[j] = base.brand_audience[j0];
+        inst.brand_time[j] = base.brand_time[j0];
+        inst.grp_cap[j] = base.grp_cap[j0];
+        inst.budget_cap[j] = base.budget_cap[j0];
+        inst.prime[j] = base.prime[j0];
+        inst.premium[j] = base.premium[j0];
+        inst.priority[j] = base.priority[j0];
+    }
+    return inst;
+}
+
+static int bench_grp(const string& break_path, const string& brand_path, int replication, int brand_copies)
+{
+    Instance inst = replicate_instance(load_instance(break_path, brand_path), replication, brand_copies);
+    size_t pairs = (size_t) inst.nb_Com_Break * inst.nb_Brands;
+    cout << inst.nb_Com_Break << " ecrans x " << inst.nb_Brands << " marques" << endl;
+
+    auto t0 = chrono::steady_clock::now();
+    inst.build_grp_ij();
+    double t = seconds_since(t0);
+
+    cout << "grp_ij : " << t << " s, " << pairs / t / 1e6 << " M couples/s, "
+         << pairs * sizeof(float) / t / (1024.0 * 1024.0 * 1024.0) << " Go/s ecrits" << endl;
+    return 0;
+}
+
+static int bench_greedy(const string& break_path, const string& brand_path, int replication, int brand_copies)
+{
+    Instance inst = replicate_instance(load_instance(break_path, brand_path), replication, brand_copies);
+    inst.build_grp_ij();
+    inst.build_type_groups();
+    cout << inst.nb_Com_Break << " ecrans x " << inst.nb_Brands << " marques" << endl;
+
+    for (Greedy_Rule rule : { Greedy_Rule::GRP_PER_SECOND, Greedy_Rule::REVENUE_PER_SECOND }){
+        auto t0 = chrono::steady_clock::now();
+        Allocation alloc = greedy_allocation(inst, rule);
+        double t = seconds_since(t0);
+        cout << "glouton " << rule_name(rule) << " : " << t * 1000 << " ms, revenu TV " << alloc.revenue
+             << ", GRP " << alloc.grp << ", " << alloc.nb_spots << " spots" << endl;
+    }
+    return 0;
+}
+
+static int bench_search(const string& break_path, const string& brand_path, int replication, int brand_copies,
+                        double seconds, int threads)
+{
+    Instance inst = replicate_instance(load_instance(break_path, brand_path), replication, brand_copies);
+    inst.build_grp_ij();
+    inst.build_type_groups();
+    cout << inst.nb_Com_Break << " ecrans x " << inst.nb_Brands << " marques, " << threads << " threads" << endl;
+
+    Search_Options search;
+    search.time_limit = seconds;
+    search.threads = threads;
+    for (Greedy_Rule rule : { Greedy_Rule::GRP_PER_SECOND, Greedy_Rule::REVENUE_PER_SECOND }){
+        Allocation start = greedy_allocation(inst, rule);
+        search.objective = rule == Greedy_Rule::GRP_PER_SECOND ? Objective::GRP : Objective::REVENUE;
+        auto t0 = chrono::steady_clock::now();
+        Allocation alloc = local_search(inst, start, search);
+        double t = seconds_since(t0);
+        cout << "glouton " << rule_name(rule) << " : revenu TV " << start.revenue << ", GRP " << start.grp
+             << " -> recherche locale (" << t << " s) : revenu TV " << alloc.revenue << ", GRP " << alloc.grp
+             << ", " << alloc.nb_spots << " spots" << endl;
+    }
+    return 0;
+}
+
+static int bench_knapsack(const string& break_path, const string& brand_path, int replication, int brand_copies)
+{
+    Instance inst = replicate_instance(load_instance(break_path, brand_path), replication, brand_copies);
+    inst.build_grp_ij();
+    inst.build_type_groups();
+    cout << inst.nb_Com_Break << " ecrans x " << inst.nb_Brands << " marques, noyau " << knapsack_isa() << endl;
+
+    double totals[2];
+    for (int vectorized = 0; vectorized < 2; vectorized++){
+        Break_Knapsack knapsack(vectorized);
+        double total = 0;
+        long spots = 0;
+        auto t0 = chrono::steady_clock::now();
+        for (int i = 0; i < inst.nb_Com_Break; i++){
+            knapsack.clear();
+            for (int t = 0; t < inst.nb_Types(); t++){
+                knapsack.begin_group();
+                for (const int* it = inst.type_begin(t); it != inst.type_end(t); ++it){
+                    knapsack.add_item(*it, (int) inst.brand_time[*it], inst.grp_of(i, *it));
+                }
+            }
+            total += knapsack.solve((int) inst.break_time[i]);
+            spots += knapsack.chosen().size();
+        }
+        double t = seconds_since(t0);
+        totals[vectorized] = total;
+        cout << (vectorized ? "vectorise" : "scalaire ") << " : " << t * 1000 << " ms, "
+             << inst.nb_Com_Break / t / 1e6 << " M ecrans/s, GRP " << total << ", " << spots << " spots" << endl;
+    }
+    if (totals[0] != totals[1]){
+        cerr << "Valeurs differentes entre les deux noyaux" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+static double file_size_mb(const string& path)
+{
+    ifstream f(path, ios::binary | ios::ate);
+    return f.tellg() / (1024.0 * 1024.0);
+}
+
+// Ecrit le document dans "base + ext" au format demandé
+static string write_format(const json& doc, const string& base, Input_Format format)
+{
+    static const char* ext[] = { ".json", ".cbor", ".msgpack", ".bson" };
+    string path = base + ext[(int) format];
+    vector<uint8_t> bytes;
+    switch (format){
+        case Input_Format::CBOR:    bytes = json::to_cbor(doc); break;
+        case Input_Format::MSGPACK: bytes = json::to_msgpack(doc); break;
+        case Input_Format::BSON:    bytes = json::to_bson(doc); break;
+        default: {
+            string text = doc.dump();
+            bytes.assign(text.begin(), text.end());
+        }
+    }
+    ofstream out(path, ios::binary);
+    out.write((const char*) bytes.data(), bytes.size());
+    return path;
+}
+
+static int bench_formats(const string& break_path, const string& brand_path, int replication)
+{
+    Temp_Dir dir;
+    string file = replication > 1 ? replicate_breaks(break_path, replication, dir) : break_path;
+    json breaks, brands;
+    {
+        ifstream bks(file);
+        breaks = json::parse(bks);
+        ifstream bds(brand_path);
+        brands = json::parse(bds);
+    }
+    Instance reference = load_instance(file, brand_path);
+
+    const Input_Format formats[] = { Input_Format::JSON, Input_Format::CBOR, Input_Format::MSGPACK, Input_Format::BSON };
+    for (Input_Format format : formats){
+        string bk = write_format(breaks, dir.file("breaks"), format);
+        string bd = write_format(brands, dir.file("brands"), format);
+        if (detect_format(bk) != format){
+            cerr << "ERREUR : format mal detecte pour " << bk << endl;
+            return 1;
+        }
+
+        double size_mb = file_size_mb(bk);
+        auto t0 = chrono::steady_clock::now();
+        Instance inst = load_instance(bk, bd);
+        double t = seconds_since(t0);
+
+        cout << format_name(format) << " : " << size_mb << " Mo, " << t << " s, "
+             << size_mb / t << " Mo/s, " << inst.nb_Com_Break / t << " ecrans/s" << endl;
+
+        if (!same_data(reference, inst) || !same_column(reference.grp_ij, inst.grp_ij)
+            || !same_column(reference.budget_cap, inst.budget_cap)){
+            cerr << "ERREUR : donnees differentes en " << format_name(format) << endl;
+            return 1;
+        }
+        remove(bk.c_str());
+        remove(bd.c_str());
+    }
+    return 0;
+}
+
+// Ecrit "copies" exemplaires de chaque entrée du document, renumérotées
+static void write_replicated(const json& doc, int copies, const string& out_path)
+{
+    int size = (int) doc.size();
+    ofstream out(out_path);
+    out << "{";
+    int cpt = 0;
+    for (int r = 0; r < copies; r++){
+        for (const auto& item : doc.items()){
+            out << (cpt ? ",\n" : "\n") << '"' << (r * size + stoi(item.key())) << "\": " << item.value().dump();
+            cpt++;
+        }
+    }
+    out << "\n}\n";
+}
+
+static int bench_scale(const string& break_path, const string& brand_path, int replication, int brand_copies,
+                       const string& prefix)
+{
+    json breaks, brands;
+    {
+        ifstream bks(break_path);
+        breaks = json::parse(bks);
+        ifstream bds(brand_path);
+        brands = json::parse(bds);
+    }
+    string bk = prefix + "_breaks.json";
+    string bd = prefix + "_brands.json";
+    write_replicated(breaks, replication, bk);
+    write_replicated(brands, brand_copies, bd);
+
+    Instance inst = load_instance(bk, bd);
+    size_t m = inst.nb_Com_Break, n = inst.nb_Brands;
+
+    size_t clique_rows = 0;
+    for (int t = 0; t < inst.nb_Types(); t++){
+        clique_rows += inst.type_size(t) >= 2 ? m : 0;
+    }
+
+    cout << "Instance : " << bk << " , " << bd << endl;
+    cout << m << " ecrans x " << n << " marques, " << inst.nb_Types() << " types" << endl;
+    cout << "Marques concurrentes, formulation quadratique : " << m * n * (n - 1) << " contraintes quadratiques" << endl;
+    cout << "Marques concurrentes, formulation par cliques : " << clique_rows << " contraintes lineaires" << endl;
+    return 0;
+}
+
+static int bench_cache(const string& break_path, const string& brand_path, const string& cache_path)
+{
+    auto t0 = chrono::steady_clock::now();
+    Instance json_inst = load_instance(break_path, brand_path);
+    double t_json = seconds_since(t0);
+
+    t0 = chrono::steady_clock::now();
+    uint64_t hash = source_hash(break_path, brand_path);
+    double t_hash = seconds_since(t0);
+
+    if (!save_instance_cache(json_inst, hash, cache_path)){
+        cerr << "ERREUR : ecriture du cache impossible" << endl;
+        return 1;
+    }
+
+    t0 = chrono::steady_clock::now();
+    Instance cached;
+    bool ok = load_instance_cache(cache_path, hash, cached);
+    double t_cache = seconds_since(t0);
+
+    if (!ok || !same_data(json_inst, cached) || !same_column(json_inst.grp_ij, cached.grp_ij)
+        || !same_column(json_inst.budget_cap, cached.budget_cap) || !same_column(json_inst.brand_type, cached.brand_type)
+        || json_inst.types.names != cached.types.names || !same_column(json_inst.type_brands, cached.type_brands)){
+        cerr << "ERREUR : le cache differe de l'instance JSON" << endl;
+        return 1;
+    }
+    if (load_instance_cache(cache_path, hash + 1, cached)){
+        cerr << "ERREUR : un cache perime a ete accepte" << endl;
+        return 1;
+    }
+
+    cout << "JSON : " << t_json << " s" << endl;
+    cout << "Empreinte des sources : " << t_hash << " s" << endl;
+    cout << "Cache (mmap) : " << t_cache << " s" << endl;
+    return 0;
+}
+
+// Front de Pareto de solve_instance, relu dans dir/front.txt ; l'affichage
+// de la résolution est écarté
+static vector<Pareto_Point> solve_front(const Instance& inst, const Options& opt, const string& dir)
+{
+    streambuf* out = cout.rdbuf(nullptr);
+    try {
+        solve_instance(inst, opt, dir);
+    }
+    catch (...) {
+        cout.rdbuf(out);
+        throw;
+    }
+    cout.rdbuf(out);
+
+    Pareto_Archive archive(opt.objectives);
+    archive.load(dir + "/front.txt");
+    return archive.points();
+}
+
+static bool same_front(const vector<Pareto_Point>& a, const vector<Pareto_Point>& b)
+{
+    if (a.size() != b.size()){
+        return false;
+    }
+    for (size_t k = 0; k < a.size(); k++){
+        if (fabs(a[k].revenue() - b[k].revenue()) > PARETO_EPS * max(1.0, fabs(a[k].revenue()))
+            || fabs(a[k].grp() - b[k].grp()) > PARETO_EPS * max(1.0, fabs(a[k].grp()))){
+            return false;
+        }
+    }
+    return true;
+}
+
+// Sous-instance des nb_breaks premiers écrans
+static Instance first_breaks(const string& break_path, const string& brand_path, int nb_breaks)
+{
+    Instance base = load_instance(break_path, brand_path);
+    vector<int> breaks;
+    for (int i = 0; i < min(nb_breaks, base.nb_Com_Break); i++){
+        breaks.push_back(i);
+    }
+    return base.select_breaks(breaks);
+}
+
+static int bench_front(const string& break_path, const string& brand_path, int nb_breaks,
+                       const vector<int>& intervals)
+{
+    Instance inst = first_breaks(break_path, brand_path, nb_breaks);
+    cout << inst.nb_Com_Break << " ecrans x " << inst.nb_Brands << " marques" << endl;
+
+    Temp_Dir dir;
+    Options opt;
+    opt.solver = "native";
+    auto t0 = chrono::steady_clock::now();
+    vector<Pareto_Point> reference = solve_front(inst, opt, dir.path);
+    cout << "sequentiel : " << reference.size() << " points, " << seconds_since(t0) << " s" << endl;
+
+    int status = 0;
+    opt.parallel = 2;
+    for (int k : intervals){
+        opt.intervals = k;
+        t0 = chrono::steady_clock::now();
+        vector<Pareto_Point> front = solve_front(inst, opt, dir.path);
+        cout << "parallele, " << k << " intervalles : " << front.size() << " points, "
+             << seconds_since(t0) << " s" << endl;
+        if (!same_front(reference, front)){
+            cerr << "ERREUR : le front parallele (" << k << " intervalles) differe du front sequentiel" << endl;
+            status = 1;
+        }
+    }
+    return status;
+}
+
+// Allocation des valeurs x_ij (m * n, > 0.5 = 1), objectifs recalculés
+static Allocation to_allocation(const Instance& inst, const vector<double>& values)
+{
+    int n = inst.nb_Brands;
+    Allocation alloc;
+    alloc.x.assign((size_t) inst.nb_Com_Break * n, 0);
+    for (int i = 0; i < inst.nb_Com_Break; i++){
+        for (int j = 0; j < n; j++){
+            if (values[(size_t) i * n + j] > 0.5){
+                alloc.x[(size_t) i * n + j] = 1;
+                alloc.revenue += inst.cost(i, j) * inst.brand_time[j];
+                alloc.grp += inst.grp_of(i, j);
+                alloc.nb_spots++;
+            }
+        }
+    }
+    return alloc;
+}
+
+// L'allocation respecte les durées des écrans, les exclusions des marques
+// concurrentes et les budgets, et ses objectifs sont ceux de ses x_ij
+static bool feasible(const Instance& inst, const Allocation& alloc)
+{
+    int n = inst.nb_Brands;
+    vector<double> spend(n, 0);
+    double revenue = 0, grp = 0;
+    for (int i = 0; i < inst.nb_Com_Break; i++){
+        double time = 0;
+        vector<int> per_type(inst.nb_Types(), 0);
+        for (int j = 0; j < n; j++){
+            if (!alloc.x[(size_t) i * n + j])
+                continue;
+            time += inst.brand_time[j];
+            if (++per_type[inst.brand_type[j]] > 1)
+                return false;
+            spend[j] += inst.cost(i, j) * inst.brand_time[j];
+            revenue += inst.cost(i, j) * inst.brand_time[j];
+            grp += inst.grp_of(i, j);
+        }
+        if (time > inst.break_time[i] + PARETO_EPS)
+            return false;
+    }
+    for (int j = 0; j < n; j++){
+        if (spend[j] > inst.budget_cap[j] + PARETO_EPS)
+            return false;
+    }
+    return fabs(revenue - alloc.revenue) <= PARETO_EPS * max(1.0, revenue)
+        && fabs(grp - alloc.grp) <= 1e-4 * max(1.0, grp);
+}
+
+static double value_of(const Allocation& alloc, Objective objective)
+{
+    return objective == Objective::GRP ? alloc.grp : alloc.revenue;
+}
+
+static const char* objective_name(Objective objective)
+{
+    return objective == Objective::GRP ? "GRP" : "revenu TV";
+}
+
+// Optimum du modèle exact (solveur natif, opt.presolve et opt.aggregate
+// respectés) et son allocation
+static Allocation exact_optimum(const Instance& inst, const Options& opt, Objective objective)
+{
+    Presolve pre = presolve(inst, opt);
+    Allocation_Model model(inst, opt, pre);
+    model.quiet();
+    if (objective == Objective::GRP)
+        model.maximize_grp();
+    else
+        model.maximize_revenue();
+    if (!model.solve() || model.status() != Solve_Status::OPTIMAL){
+        throw runtime_error(string("Optimum ") + objective_name(objective) + " non trouve");
+    }
+    return to_allocation(inst, model.allocation_values());
+}
+
+// Affiche le résultat d'une vérification ; renvoie 1 si elle échoue
+static int check(bool ok, const string& what)
+{
+    if (ok)
+        cout << "ok : " << what << endl;
+    else
+        cerr << "ERREUR : " << what << endl;
+    return ok ? 0 : 1;
+}
+
+// Vérifications d'un objectif : chaque méthode est comparée à l'optimum du
+// modèle exact, à l'écart relatif NATIVE_MIP_GAP près ; les échecs sont
+// comptés dans nb_failed
+struct Check_Context {
+    const Instance& inst;
+    Options opt;                // solveur natif
+    Objective objective;
+    string name;                // nom de l'objectif
+    double optimum;
+    int nb_failed = 0;
+
+    double tolerance(double reference) const { return NATIVE_MIP_GAP * max(1.0, reference); }
+
+    void expect(bool ok, const string& what) { nb_failed += check(ok, what); }
+
+    // Allocation réalisable, jamais meilleure que l'optimum
+    void expect_below(const Allocation& alloc, const string& what)
+    {
+        expect(feasible(inst, alloc), what + " realisable");
+        expect(value_of(alloc, objective) <= optimum + tolerance(optimum), what + " <= optimum");
+    }
+
+    // Borne supérieure valide
+    void expect_bound(double bound, const string& what)
+    {
+        expect(bound >= optimum - PARETO_EPS * max(1.0, optimum), what + " >= optimum");
+    }
+
+    // Allocation réalisable de sub, de même valeur que l'optimum reference
+    // d'un autre modèle de sub
+    void expect_same(const Instance& sub, const Allocation& alloc, double reference, const string& what,
+                     const string& reference_name)
+    {
+        expect(feasible(sub, alloc), what + " realisable");
+        expect(fabs(value_of(alloc, objective) - reference) <= tolerance(reference), what + " = " + reference_name);
+    }
+};
+
+// Glouton : réalisable, jamais meilleur que l'optimum
+static void check_greedy(Check_Context& c)
+{
+    for (Greedy_Rule rule : { Greedy_Rule::GRP_PER_SECOND, Greedy_Rule::REVENUE_PER_SECOND }){
+        c.expect_below(greedy_allocation(c.inst, rule), string("glouton ") + rule_name(rule) + ", " + c.name);
+    }
+}
+
+// Relaxation lagrangienne des budgets : borne supérieure
+static void check_lagrangian(Check_Context& c)
+{
+    Lagrangian_Options lag;
+    lag.objective = c.objective;
+    lag.time_limit = 10;
+    Lagrangian_Bound bound = lagrangian_bound(c.inst, lag);
+    cout << "borne lagrangienne " << c.name << " : " << bound.upper_bound << endl;
+    c.expect_bound(bound.upper_bound, "borne lagrangienne " + c.name);
+}
+
+// Génération de colonnes : solution réalisable, bornes valides
+static void check_colgen(Check_Context& c)
+{
+    vector<Allocation> starts;
+    for (Greedy_Rule rule : { Greedy_Rule::GRP_PER_SECOND, Greedy_Rule::REVENUE_PER_SECOND }){
+        starts.push_back(greedy_allocation(c.inst, rule));
+    }
+    Colgen_Result cg = column_generation(c.inst, c.opt, c.objective, starts);
+    cout << "generation de colonnes " << c.name << " : " << value_of(cg.allocation, c.objective)
+         << ", relaxation " << cg.lp_value << ", borne " << cg.upper_bound << endl;
+    string what = "generation de colonnes " + c.name;
+    c.expect_below(cg.allocation, what);
+    c.expect_bound(cg.upper_bound, "borne de la " + what);
+    if (cg.converged)
+        c.expect_bound(cg.lp_value, "relaxation du maitre " + c.name);
+}
+
+// Presolve : même optimum que le modèle complet, allocation reconstruite
+// réalisable ; avec des budgets serrés, il retire davantage de couples
+static void check_presolve(Check_Context& c)
+{
+    Options full = c.opt;
+    full.presolve = false;
+    for (double scale : { 1.0, 0.25 }){
+        Instance tight = c.inst;
+        for (int j = 0; j < tight.nb_Brands; j++){
+            tight.set_budget(j, floor(c.inst.budget_cap[j] * scale));
+        }
+        Allocation reduced = exact_optimum(tight, c.opt, c.objective);
+        double reference = value_of(exact_optimum(tight, full, c.objective), c.objective);
+        c.expect_same(tight, reduced, reference, "presolve, budgets x" + to_string(scale).substr(0, 4) + ", " + c.name,
+                      "optimum du modele complet");
+    }
+}
+
+// Agrégation des écrans interchangeables (écrans recopiés 3 fois : des
+// classes à agréger) : même optimum que le modèle non agrégé, comptes
+// répartis en une allocation réalisable
+static void check_aggregation(Check_Context& c)
+{
+    Instance copies = replicate_instance(c.inst, 3, 1);
+    copies.build_grp_ij();
+    copies.build_type_groups();
+    Options aggregated = c.opt;
+    aggregated.aggregate = true;
+    Allocation expanded = exact_optimum(copies, aggregated, c.objective);
+    double reference = value_of(exact_optimum(copies, c.opt, c.objective), c.objective);
+    int nb_classes = presolve(copies, aggregated).stats.nb_classes;
+    c.expect_same(copies, expanded, reference, "agregation (" + to_string(nb_classes) + " classes), " + c.name,
+                  "optimum non agrege");
+}
+
+// Allocation gloutonne de l'objectif, départ des méthodes approchées
+static Allocation greedy_start(const Check_Context& c)
+{
+    return greedy_allocation(c.inst, c.objective == Objective::GRP ? Greedy_Rule::GRP_PER_SECOND
+                                                                   : Greedy_Rule::REVENUE_PER_SECOND);
+}
+
+// Décomposition par station : réalisable pour les budgets globaux, jamais
+// moins bonne que son départ glouton ni meilleure que l'optimum
+static void check_decomposition(Check_Context& c)
+{
+    Allocation start = greedy_start(c);
+    Options split = c.opt;
+    split.decompose = 5;
+    split.threads = 2;
+    Decomposition_Result dec = decompose_stations(c.inst, split, c.objective, start);
+    double value = value_of(dec.allocation, c.objective);
+    string what = "decomposition (" + to_string(dec.nb_stations) + " stations), " + c.name;
+    c.expect_below(dec.allocation, what);
+    c.expect(value >= value_of(start, c.objective) - PARETO_EPS * max(1.0, value), what + " >= glouton");
+}
+
+// Horizon glissant (fenêtres de 2 jours, recouvrement d'un jour) :
+// réalisable pour les budgets globaux, pas meilleur que l'optimum
+static void check_rolling(Check_Context& c)
+{
+    Options rolling = c.opt;
+    rolling.window = 2;
+    rolling.overlap = 1;
+    Rolling_Result rh = rolling_horizon(c.inst, rolling, c.objective, greedy_start(c));
+    c.expect_below(rh.allocation, "horizon glissant (" + to_string(rh.nb_windows) + " fenetres), " + c.name);
+}
+
+// Vérifications faites pour chaque objectif
+static void (* const objective_checks[])(Check_Context&) = {
+    check_greedy,
+    check_lagrangian,
+    check_colgen,
+    check_presolve,
+    check_aggregation,
+    check_decomposition,
+    check_rolling,
+};
+
+// Meilleur profit grp_ij de l'écran i par énumération de tous les
+// ensembles de marques (au plus une par type)
+static double best_subset(const Instance& inst, int i)
+{
+    int n = inst.nb_Brands;
+    double best = 0;
+    for (int set = 0; set < (1 << n); set++){
+        int w = 0;
+        double profit = 0;
+        vector<int> per_type(inst.nb_Types(), 0);
+        bool ok = true;
+        for (int j = 0; j < n && ok; j++){
+            if (set >> j & 1){
+                w += (int) inst.brand_time[j];
+                profit += inst.grp_of(i, j);
+                ok = ++per_type[inst.brand_type[j]] <= 1;
+            }
+        }
+        if (ok && w <= (int) inst.break_time[i])
+            best = max(best, profit);
+    }
+    return best;
+}
+
+// Sac à dos par écran (profit grp_ij, marques recopiées 3 fois pour
+// remplir les groupes) : scalaire et vectorisé égaux à l'énumération, et
+// items retenus cohérents
+static int check_knapsack(const Instance& inst)
+{
+    Instance wide = replicate_instance(inst, 1, 3);
+    wide.build_grp_ij();
+    wide.build_type_groups();
+    if (wide.nb_Brands > 16){
+        cout << "sac a dos : " << wide.nb_Brands << " marques, trop pour l'enumeration" << endl;
+        return 0;
+    }
+    bool ok = true;
+    for (int vectorized = 0; vectorized < 2 && ok; vectorized++){
+        Break_Knapsack knapsack(vectorized);
+        for (int i = 0; i < wide.nb_Com_Break && ok; i++){
+            int C = (int) wide.break_time[i];
+            knapsack.clear();
+            for (int t = 0; t < wide.nb_Types(); t++){
+                knapsack.begin_group();
+                for (const int* it = wide.type_begin(t); it != wide.type_end(t); ++it){
+                    knapsack.add_item(*it, (int) wide.brand_time[*it], wide.grp_of(i, *it));
+                }
+            }
+            double value = knapsack.solve(C);
+            double best = best_subset(wide, i);
+
+            int w = 0;
+            double profit = 0;
+            vector<int> per_type(wide.nb_Types(), 0);
+            for (const auto& item : knapsack.chosen()){
+                w += item.w;
+                profit += item.profit;
+                ok &= ++per_type[wide.brand_type[item.id]] <= 1;
+            }
+            ok &= fabs(value - best) <= 1e-4 * max(1.0, best) && fabs(profit - value) <= 1e-4 * max(1.0, value)
+               && w <= C;
+        }
+    }
+    return check(ok, "sac a dos de chaque ecran (scalaire et vectorise) = enumeration");
+}
+
+// Archive de Pareto (2 et 4 objectifs) : points entiers tirés au hasard
+// près de l'hyperplan sum = cste (front étendu, doublons et égalités),
+// même front que le filtrage de tous les points deux à deux, y compris
+// après save / load
+static int check_pareto_archive()
+{
+    Temp_Dir dir;
+    mt19937 rng(1);
+    int nb_failed = 0;
+    for (int dim : { 2, 4 }){
+        const int R = dim == 2 ? 1000 : 20;
+        uniform_int_distribution<int> coord(0, R), noise(0, 3);
+        vector<Pareto_Point> all(3000);
+        Pareto_Archive archive(dim);
+        for (size_t k = 0; k < all.size(); k++){
+            double sum = 0;
+            for (int d = 0; d + 1 < dim; d++){
+                all[k].objectives[d] = coord(rng);
+                sum += all[k].objectives[d];
+            }
+            all[k].objectives[dim - 1] = (dim - 1) * R - sum - noise(rng);
+            all[k].x = { (uint64_t) k };
+            archive.insert(all[k]);
+        }
+
+        set<vector<double>> expected;
+        for (const auto& p : all){
+            bool dominated = false;
+            for (const auto& q : all){
+                if (dominates(q, p, dim)){
+                    dominated = true;
+                    break;
+                }
+            }
+            if (!dominated)
+                expected.insert(vector<double>(p.objectives.begin(), p.objectives.begin() + dim));
+        }
+        auto front_of = [&](const Pareto_Archive& a){
+            vector<vector<double>> res;
+            for (const auto& p : a.points()){
+                res.push_back(vector<double>(p.objectives.begin(), p.objectives.begin() + dim));
+            }
+            sort(res.begin(), res.end());
+            return res;
+        };
+        vector<vector<double>> front = front_of(archive);
+        archive.save(dir.file("front.txt"));
+        Pareto_Archive reloaded(dim);
+        reloaded.load(dir.file("front.txt"));
+
+        string what = "archive de Pareto, " + to_string(dim) + " objectifs (" + to_string(expected.size()) + " points)";
+        nb_failed += check(front == vector<vector<double>>(expected.begin(), expected.end()) && front_of(reloaded) == front,
+                           what + " = filtrage deux a deux");
+    }
+    return nb_failed;
+}
+
+// Vérifications de comportement sur une petite instance
+static int bench_check(const string& break_path, const string& brand_path, int nb_breaks)
+{
+    Instance inst = first_breaks(break_path, brand_path, nb_breaks);
+    cout << inst.nb_Com_Break << " ecrans x " << inst.nb_Brands << " marques" << endl;
+
+    Options opt;
+    opt.solver = "native";
+    int nb_failed = 0;
+    for (Objective objective : { Objective::REVENUE, Objective::GRP }){
+        Allocation best = exact_optimum(inst, opt, objective);
+        Check_Context c = { inst, opt, objective, objective_name(objective), value_of(best, objective) };
+        cout << "optimum " << c.name << " : " << c.optimum << endl;
+        c.expect(feasible(inst, best), "optimum " + c.name + " realisable");
+        for (auto run : objective_checks){
+            run(c);
+        }
+        nb_failed += c.nb_failed;
+    }
+    nb_failed += check_knapsack(inst);
+    nb_failed += check_pareto_archive();
+    return nb_failed > 0 ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 3 && strcmp(argv[1], "load") == 0){
+        return bench_load(argv[2], argc >= 4 ? atoi(argv[3]) : 1);
+    }
+    if (argc >= 4 && strcmp(argv[1], "formats") == 0){
+        return bench_formats(argv[2], argv[3], argc >= 5 ? atoi(argv[4]) : 1);
+    }
+    if (argc >= 7 && strcmp(argv[1], "scale") == 0){
+        return bench_scale(argv[2], argv[3], atoi(argv[4]), atoi(argv[5]), argv[6]);
+    }
+    if (argc >= 5 && strcmp(argv[1], "cache") == 0){
+        return bench_cache(argv[2], argv[3], argv[4]);
+    }
+    if (argc >= 6 && strcmp(argv[1], "grp") == 0){
+        return bench_grp(argv[2], argv[3], atoi(argv[4]), atoi(argv[5]));
+    }
+    if (argc >= 6 && strcmp(argv[1], "greedy") == 0){
+        return bench_greedy(argv[2], argv[3], atoi(argv[4]), atoi(argv[5]));
+    }
+    if (argc >= 5 && strcmp(argv[1], "knapsack") == 0){
+        return bench_knapsack(argv[2], argv[3], atoi(argv[4]), argc >= 6 ? atoi(argv[5]) : 1);
+    }
+    if (argc >= 7 && strcmp(argv[1], "search") == 0){
+        return bench_search(argv[2], argv[3], atoi(argv[4]), atoi(argv[5]), atof(argv[6]),
+                            argc >= 8 ? atoi(argv[7]) : 1);
+    }
+    if (argc >= 5 && strcmp(argv[1], "check") == 0){
+        return bench_check(argv[2], argv[3], atoi(argv[4]));
+    }
+    if (argc >= 6 && strcmp(argv[1], "front") == 0){
+        vector<int> intervals;
+        for (int k = 5; k < argc; k++){
+            intervals.push_back(atoi(argv[k]));
+        }
+        return bench_front(argv[2], argv[3], atoi(argv[4]), intervals);
+    }
+
+    cerr << "Utilisation : " << argv[0] << " load <break.json> [replication]" << endl;
+    cerr << "              " << argv[0] << " grp <break.json> <brands.json> <replication> <copies_marques>" << endl;
+    cerr << "              " << argv[0] << " formats <break.json> <brands.json> [replication]" << endl;
+    cerr << "              " << argv[0] << " scale <break.json> <brands.json> <replication> <copies_marques> <prefixe>" << endl;
+    cerr << "              " << argv[0] << " cache <break.json> <brands.json> <cache>" << endl;
+    cerr << "              " << argv[0] << " greedy <break.json> <brands.json> <replication> <copies_marques>" << endl;
+    cerr << "              " << argv[0] << " search <break.json> <brands.json> <replication> <copies_marques> <secondes> [threads]" << endl;
+    cerr << "              " << argv[0] << " knapsack <break.json> <brands.json> <replication> [copies_marques]" << endl;
+    cerr << "              " << argv[0] << " check <break.json> <brands.json> <ecrans>" << endl;
+    cerr << "              " << argv[0] << " front <break.json> <brands.json> <ecrans> <intervalles> [intervalles ...]" << endl;
+    return 1;
+}
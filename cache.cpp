@@ -0,0 +1,319 @@
+/*
+ Cache binaire de l'instance : écriture et rechargement par projection mémoire.
+ */
+
+#include "cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "loader.h"
+
+using namespace std;
+
+
+namespace {
+
+const char CACHE_MAGIC[8] = { 'S', 'P', 'O', 'T', 'I', 'N', 'S', 'T' };
+const uint32_t CACHE_ENDIAN = 0x01020304;
+
+struct Cache_Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian;            // détecte un fichier écrit sur une machine d'autre boutisme
+    uint64_t source_hash;
+    int32_t nb_Com_Break;
+    int32_t nb_Brands;
+    int32_t nb_Audiences;
+    int32_t nb_Slots;
+    uint64_t names_offset;
+    uint64_t names_size;
+    uint64_t nb_columns;
+    uint64_t file_size;
+};
+
+struct Cache_Entry {
+    uint32_t elem_size;
+    uint32_t unused;
+    uint64_t count;
+    uint64_t offset;
+};
+
+uint64_t align_up(uint64_t x)
+{
+    return (x + COLUMN_ALIGN - 1) / COLUMN_ALIGN * COLUMN_ALIGN;
+}
+
+// Longueur attendue d'une colonne, en fonction des dimensions de l'instance
+enum class Extent { BREAKS, BRANDS, TYPE_BOUNDS, PAIRS };
+
+// Parcourt toutes les colonnes de l'instance dans l'ordre du fichier
+template <typename Inst, typename F>
+void for_each_column(Inst& inst, F f)
+{
+    f(inst.break_time, Extent::BREAKS);
+    f(inst.prime_break, Extent::BREAKS);
+    f(inst.station, Extent::BREAKS);
+    f(inst.start_date, Extent::BREAKS);
+    f(inst.delay, Extent::BREAKS);
+    for (auto& col : inst.grp){
+        f(col, Extent::BREAKS);
+    }
+    for (int s = 0; s < NB_SLOTS; s++){
+        f(inst.slot_price[s], Extent::BREAKS);
+        f(inst.slot_available[s], Extent::BREAKS);
+    }
+    f(inst.brand_type, Extent::BRANDS);
+    f(inst.brand_audience, Extent::BRANDS);
+    f(inst.brand_time, Extent::BRANDS);
+    f(inst.grp_cap, Extent::BRANDS);
+    f(inst.budget_cap, Extent::BRANDS);
+    f(inst.prime, Extent::BRANDS);
+    f(inst.premium, Extent::BRANDS);
+    f(inst.priority, Extent::BRANDS);
+    f(inst.type_start, Extent::TYPE_BOUNDS);
+    f(inst.type_brands, Extent::BRANDS);
+    f(inst.grp_ij, Extent::PAIRS);
+}
+
+void write_names(string& out, const vector<string>& names)
+{
+    uint32_t count = (uint32_t) names.size();
+    out.append((const char*) &count, sizeof(count));
+    for (const auto& name : names){
+        uint32_t len = (uint32_t) name.size();
+        out.append((const char*) &len, sizeof(len));
+        out.append(name);
+    }
+}
+
+bool read_names(const char*& p, const char* end, vector<string>& names)
+{
+    uint32_t count;
+    if (end - p < (ptrdiff_t) sizeof(count)){
+        return false;
+    }
+    memcpy(&count, p, sizeof(count));
+    p += sizeof(count);
+    names.clear();
+    for (uint32_t k = 0; k < count; k++){
+        uint32_t len;
+        if (end - p < (ptrdiff_t) sizeof(len)){
+            return false;
+        }
+        memcpy(&len, p, sizeof(len));
+        p += sizeof(len);
+        if (end - p < (ptrdiff_t) len){
+            return false;
+        }
+        names.emplace_back(p, len);
+        p += len;
+    }
+    return true;
+}
+
+void hash_file(const string& path, uint64_t& h)
+{
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f){
+        throw runtime_error("Impossible d'ouvrir " + path);
+    }
+    vector<unsigned char> buf(1 << 20);
+    size_t len;
+    while ((len = fread(buf.data(), 1, buf.size(), f)) > 0){
+        for (size_t k = 0; k < len; k++){
+            h ^= buf[k];
+            h *= 0x100000001b3ULL;
+        }
+    }
+    fclose(f);
+}
+
+}
+
+
+uint64_t source_hash(const string& break_path, const string& brand_path)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    hash_file(break_path, h);
+    hash_file(brand_path, h);
+    return h;
+}
+
+
+bool save_instance_cache(const Instance& inst, uint64_t hash, const string& path)
+{
+    string names;
+    write_names(names, inst.audiences.names);
+    write_names(names, inst.types.names);
+
+    vector<Cache_Entry> entries;
+    for_each_column(inst, [&](const auto& col, Extent){
+        Cache_Entry e = {};
+        e.elem_size = sizeof(col[0]);
+        e.count = col.size();
+        entries.push_back(e);
+    });
+
+    Cache_Header h = {};
+    memcpy(h.magic, CACHE_MAGIC, sizeof(h.magic));
+    h.version = CACHE_VERSION;
+    h.endian = CACHE_ENDIAN;
+    h.source_hash = hash;
+    h.nb_Com_Break = inst.nb_Com_Break;
+    h.nb_Brands = inst.nb_Brands;
+    h.nb_Audiences = inst.nb_Audiences();
+    h.nb_Slots = NB_SLOTS;
+    h.names_offset = sizeof(h) + entries.size() * sizeof(Cache_Entry);
+    h.names_size = names.size();
+    h.nb_columns = entries.size();
+
+    uint64_t offset = align_up(h.names_offset + h.names_size);
+    for (auto& e : entries){
+        e.offset = offset;
+        offset = align_up(offset + e.count * e.elem_size);
+    }
+    h.file_size = offset;
+
+    // écriture dans un fichier temporaire puis renommage : un cache à moitié
+    // écrit n'est jamais lu
+    string tmp_path = path + ".tmp";
+    ofstream out(tmp_path, ios::binary | ios::trunc);
+    if (!out){
+        return false;
+    }
+    out.write((const char*) &h, sizeof(h));
+    out.write((const char*) entries.data(), entries.size() * sizeof(Cache_Entry));
+    out.write(names.data(), names.size());
+
+    static const char zeros[COLUMN_ALIGN] = {};
+    size_t k = 0;
+    for_each_column(inst, [&](const auto& col, Extent){
+        const Cache_Entry& e = entries[k++];
+        uint64_t pos = (uint64_t) out.tellp();
+        out.write(zeros, e.offset - pos);
+        out.write((const char*) col.data(), e.count * e.elem_size);
+    });
+    uint64_t pos = (uint64_t) out.tellp();
+    out.write(zeros, h.file_size - pos);
+
+    out.close();
+    if (!out){
+        remove(tmp_path.c_str());
+        return false;
+    }
+    return rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+
+bool load_instance_cache(const string& path, uint64_t hash, Instance& inst)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0){
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(Cache_Header)){
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t) st.st_size;
+
+    // MAP_PRIVATE : une écriture dans une colonne ne modifie pas le fichier
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED){
+        return false;
+    }
+    shared_ptr<void> mapping(addr, [size](void* p){ munmap(p, size); });
+    char* base = static_cast<char*>(addr);
+
+    Cache_Header h;
+    memcpy(&h, base, sizeof(h));
+    if (memcmp(h.magic, CACHE_MAGIC, sizeof(h.magic)) != 0 || h.version != CACHE_VERSION
+        || h.endian != CACHE_ENDIAN || h.source_hash != hash || h.file_size != size
+        || h.nb_Slots != NB_SLOTS || h.nb_Com_Break < 0 || h.nb_Brands < 0){
+        return false;
+    }
+    // bornes testées par soustraction : un en-tête corrompu ne doit pas
+    // pouvoir faire déborder les sommes de décalages
+    if (h.nb_columns > (size - sizeof(h)) / sizeof(Cache_Entry)
+        || h.names_offset > size || h.names_size > size - h.names_offset){
+        return false;
+    }
+
+    Instance res;
+    res.nb_Com_Break = h.nb_Com_Break;
+    res.nb_Brands = h.nb_Brands;
+
+    const char* p = base + h.names_offset;
+    const char* end = p + h.names_size;
+    vector<string> audiences, types;
+    if (!read_names(p, end, audiences) || !read_names(p, end, types)
+        || (int) audiences.size() != h.nb_Audiences){
+        return false;
+    }
+    for (const auto& name : audiences){
+        res.audiences.intern(name);
+    }
+    for (const auto& name : types){
+        res.types.intern(name);
+    }
+    res.grp.resize(audiences.size());
+
+    const Cache_Entry* entries = (const Cache_Entry*) (base + sizeof(h));
+    size_t k = 0;
+    bool ok = true;
+    const uint64_t m = (uint64_t) h.nb_Com_Break;
+    const uint64_t n = (uint64_t) h.nb_Brands;
+    for_each_column(res, [&](auto& col, Extent extent){
+        using T = typename std::remove_reference<decltype(col[0])>::type;
+        if (!ok || k >= h.nb_columns){
+            ok = false;
+            return;
+        }
+        const Cache_Entry& e = entries[k++];
+        uint64_t expected = extent == Extent::BREAKS ? m
+                          : extent == Extent::BRANDS ? n
+                          : extent == Extent::TYPE_BOUNDS ? types.size() + 1
+                          : m * n;
+        if (e.elem_size != sizeof(T) || e.count != expected || e.offset % COLUMN_ALIGN != 0
+            || e.offset > size || e.count > (size - e.offset) / sizeof(T)){
+            ok = false;
+            return;
+        }
+        col = Column<T>::view((T*) (base + e.offset), e.count, mapping);
+    });
+    if (!ok || k != h.nb_columns){
+        return false;
+    }
+
+    inst = std::move(res);
+    return true;
+}
+
+
+Instance load_instance_cached(const string& break_path, const string& brand_path, const string& cache_path)
+{
+    uint64_t hash = source_hash(break_path, brand_path);
+
+    Instance inst;
+    if (load_instance_cache(cache_path, hash, inst)){
+        cout << "Instance chargee depuis le cache " << cache_path << endl;
+        return inst;
+    }
+
+    inst = load_instance(break_path, brand_path);
+    if (save_instance_cache(inst, hash, cache_path)){
+        cout << "Cache ecrit : " << cache_path << endl;
+    }
+    else {
+        cerr << "Impossible d'ecrire le cache " << cache_path << endl;
+    }
+    return inst;
+}
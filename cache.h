@@ -0,0 +1,45 @@
+/*
+ Cache binaire de l'instance.
+
+ Une fois les JSON lus, l'instance peut être écrite dans un fichier binaire
+ versionné :
+    - un en-tête fixe (signature, version, empreinte des JSON sources, tailles),
+    - un répertoire donnant pour chaque colonne sa taille d'élément, son
+      nombre d'éléments et son décalage dans le fichier,
+    - les noms (audiences, types de marques),
+    - les colonnes, chacune alignée sur COLUMN_ALIGN.
+ Au rechargement, le fichier est projeté en mémoire (mmap) et les colonnes de
+ l'instance sont des vues sur cette projection : aucune copie.
+
+ Le cache est associé à une empreinte (FNV-1a 64 bits) du contenu des deux
+ fichiers JSON : si les sources changent, il est reconstruit.
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <cstdint>
+#include <string>
+#include "instance.h"
+
+// Version du format, à incrémenter à chaque changement de disposition ou
+// des champs lus dans les sources
+const uint32_t CACHE_VERSION = 3;
+
+// Empreinte du contenu des fichiers des écrans et des marques
+uint64_t source_hash(const std::string& break_path, const std::string& brand_path);
+
+// Ecrit l'instance dans "path". Renvoie false en cas d'erreur d'écriture.
+bool save_instance_cache(const Instance& inst, uint64_t hash, const std::string& path);
+
+// Projette "path" en mémoire et remplit inst de vues sur ses colonnes.
+// Renvoie false si le fichier est absent, d'une autre version, ou construit
+// à partir d'autres sources (empreinte différente).
+bool load_instance_cache(const std::string& path, uint64_t hash, Instance& inst);
+
+// Charge l'instance depuis le cache s'il est à jour, sinon depuis les JSON
+// puis (ré)écrit le cache.
+Instance load_instance_cached(const std::string& break_path, const std::string& brand_path,
+                              const std::string& cache_path);
+
+#endif
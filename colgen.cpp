@@ -0,0 +1,247 @@
+/*
+ Génération de colonnes : maître restreint et sacs à dos des écrans.
+ */
+
+#include "colgen.h"
+#include "knapsack.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+
+namespace {
+
+const double FIT_EPS = 1e-6;
+const double REDUCED_COST_EPS = 1e-6;   // coût réduit minimal d'une nouvelle colonne
+
+// Combinaison de marques d'un écran : clé des colonnes déjà générées
+struct Pattern {
+    int i;
+    vector<int> brands;     // triées
+
+    bool operator<(const Pattern& o) const { return i != o.i ? i < o.i : brands < o.brands; }
+};
+
+// Colonnes trouvées par un thread sur son bloc d'écrans
+struct Pricing_Block {
+    double knapsack_sum = 0;
+    vector<Pattern> patterns;
+    bool repaired = false;      // une combinaison a dû être réparée
+};
+
+}
+
+
+Colgen_Result column_generation(const Instance& inst, const Options& opt, Objective objective,
+                                const vector<Allocation>& starts)
+{
+    auto t0 = chrono::steady_clock::now();
+    auto elapsed = [&](){
+        return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    };
+    int m = inst.nb_Com_Break, n = inst.nb_Brands;
+    bool by_grp = objective == Objective::GRP;
+    int nb_threads = opt.threads > 0 ? opt.threads : max(1u, thread::hardware_concurrency());
+    nb_threads = max(1, min(nb_threads, m));
+
+    auto price = [&](int i, int j){ return (double) (inst.cost(i, j) * inst.brand_time[j]); };
+    auto value = [&](int i, int j){ return by_grp ? (double) inst.grp_of(i, j) : price(i, j); };
+
+    // Lignes 0 .. n-1 : budgets, n .. n+m-1 : une combinaison par écran
+    unique_ptr<Solver_Backend> master = make_backend(opt);
+    master->quiet();
+    for (int j = 0; j < n; j++){
+        master->add_row({}, {}, -SOLVER_INFINITY, inst.budget_cap[j]);
+    }
+    for (int i = 0; i < m; i++){
+        master->add_row({}, {}, -SOLVER_INFINITY, 1);
+    }
+
+    map<Pattern, int> columns;
+    vector<Pattern> column_pattern;
+    auto add_pattern = [&](const Pattern& p){
+        auto it = columns.find(p);
+        if (it != columns.end()){
+            return it->second;
+        }
+        vector<int> rows;
+        vector<double> coefs;
+        double obj = 0;
+        for (int j : p.brands){
+            rows.push_back(j);
+            coefs.push_back(price(p.i, j));
+            obj += value(p.i, j);
+        }
+        rows.push_back(n + p.i);
+        coefs.push_back(1);
+        int c = master->add_column(obj, rows, coefs);
+        columns[p] = c;
+        column_pattern.push_back(p);
+        return c;
+    };
+
+    // Colonnes initiales : les combinaisons des allocations de départ
+    vector<vector<int>> start_columns;
+    for (const auto& alloc : starts){
+        start_columns.emplace_back();
+        for (int i = 0; i < m; i++){
+            Pattern p = { i, {} };
+            for (int j = 0; j < n; j++){
+                if (alloc.x[(size_t) i * n + j])
+                    p.brands.push_back(j);
+            }
+            if (!p.brands.empty())
+                start_columns.back().push_back(add_pattern(p));
+        }
+    }
+
+    Colgen_Result result;
+    result.upper_bound = HUGE_VAL;
+    vector<Break_Knapsack> knapsacks(nb_threads);
+    vector<Pricing_Block> blocks(nb_threads);
+    vector<double> lambda(n), sigma(m);
+
+    while (elapsed() < opt.time_limit){
+        Solve_Status st = master->solve_relaxation();
+        if (st != Solve_Status::OPTIMAL){
+            throw runtime_error(string("Generation de colonnes : relaxation du maitre ") + status_name(st));
+        }
+        result.rounds++;
+        result.lp_value = master->objective_value();
+        vector<double> duals = master->duals();
+        for (int j = 0; j < n; j++){
+            lambda[j] = max(0.0, duals[j]);
+        }
+        for (int i = 0; i < m; i++){
+            sigma[i] = max(0.0, duals[n + i]);
+        }
+
+        // Sacs à dos des écrans, un bloc contigu par thread
+        auto price_block = [&](int t){
+            Pricing_Block& b = blocks[t];
+            Break_Knapsack& knapsack = knapsacks[t];
+            b.knapsack_sum = 0;
+            b.patterns.clear();
+            b.repaired = false;
+            int end = (int) ((long long) m * (t + 1) / nb_threads);
+            for (int i = (int) ((long long) m * t / nb_threads); i < end; i++){
+                knapsack.clear();
+                for (int g = 0; g < inst.nb_Types(); g++){
+                    knapsack.begin_group();
+                    for (const int* it = inst.type_begin(g); it != inst.type_end(g); ++it){
+                        int j = *it;
+                        if (price(i, j) <= inst.budget_cap[j] + FIT_EPS){
+                            knapsack.add_item(j, (int) floor(inst.brand_time[j] + FIT_EPS),
+                                              value(i, j) - lambda[j] * price(i, j));
+                        }
+                    }
+                }
+                // Durées entières par défaut : relaxation (borne valide),
+                // mais la combinaison peut dépasser la durée réelle de
+                // l'écran ; le maître n'ayant pas de ligne de durée, elle
+                // est réparée en retirant ses marques de plus petit profit
+                double v = knapsack.solve((int) floor(inst.break_time[i] + FIT_EPS));
+                b.knapsack_sum += v;
+                if (v - sigma[i] > REDUCED_COST_EPS * max(1.0, v)){
+                    vector<Break_Knapsack::Item> chosen = knapsack.chosen();
+                    double time = 0;
+                    for (const auto& item : chosen)
+                        time += inst.brand_time[item.id];
+                    if (time > inst.break_time[i] + FIT_EPS){
+                        b.repaired = true;
+                        sort(chosen.begin(), chosen.end(), [](const Break_Knapsack::Item& a, const Break_Knapsack::Item& c){
+                            return a.profit > c.profit;
+                        });
+                        while (time > inst.break_time[i] + FIT_EPS){
+                            time -= inst.brand_time[chosen.back().id];
+                            v -= chosen.back().profit;
+                            chosen.pop_back();
+                        }
+                    }
+                    if (v - sigma[i] > REDUCED_COST_EPS * max(1.0, v)){
+                        Pattern p = { i, {} };
+                        for (const auto& item : chosen)
+                            p.brands.push_back(item.id);
+                        sort(p.brands.begin(), p.brands.end());
+                        b.patterns.push_back(p);
+                    }
+                }
+            }
+        };
+        if (nb_threads == 1){
+            price_block(0);
+        }
+        else {
+            vector<thread> threads;
+            for (int t = 0; t < nb_threads; t++){
+                threads.emplace_back(price_block, t);
+            }
+            for (auto& th : threads){
+                th.join();
+            }
+        }
+
+        // Borne lagrangienne des duales du maître
+        double L = 0;
+        for (int j = 0; j < n; j++){
+            L += lambda[j] * inst.budget_cap[j];
+        }
+        int nb_new = 0;
+        bool repaired = false;
+        for (const auto& b : blocks){
+            L += b.knapsack_sum;
+            repaired |= b.repaired;
+            for (const auto& p : b.patterns){
+                size_t before = column_pattern.size();
+                add_pattern(p);
+                nb_new += column_pattern.size() > before;
+            }
+        }
+        result.upper_bound = min(result.upper_bound, L);
+
+        // Sans combinaison réparée, aucune colonne n'améliore le maître
+        // complet ; sinon la meilleure a pu être manquée
+        if (nb_new == 0){
+            result.converged = !repaired;
+            break;
+        }
+        if (result.upper_bound - result.lp_value <= FIT_EPS * max(1.0, fabs(result.upper_bound))){
+            break;
+        }
+    }
+    result.upper_bound = min(result.upper_bound, result.converged ? result.lp_value : HUGE_VAL);
+    result.nb_columns = (int) column_pattern.size();
+
+    // Maître entier sur les colonnes générées, à partir des allocations de départ
+    for (const auto& cols : start_columns){
+        vector<double> values(column_pattern.size(), 0);
+        for (int c : cols)
+            values[c] = 1;
+        master->add_start(values, true);
+    }
+    result.status = master->solve();
+
+    Allocation& alloc = result.allocation;
+    alloc.x.assign((size_t) m * n, 0);
+    vector<double> z = master->values();
+    for (size_t c = 0; c < z.size(); c++){
+        if (z[c] < 0.5){
+            continue;
+        }
+        const Pattern& p = column_pattern[c];
+        for (int j : p.brands){
+            alloc.x[(size_t) p.i * n + j] = 1;
+            alloc.revenue += price(p.i, j);
+            alloc.grp += inst.grp_of(p.i, j);
+            alloc.nb_spots++;
+        }
+    }
+    result.time = elapsed();
+    return result;
+}
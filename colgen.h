@@ -0,0 +1,59 @@
+/*
+ Génération de colonnes sur les combinaisons de marques de chaque écran.
+
+ Au lieu des m * n variables x_ij, on choisit pour chaque écran au plus une
+ combinaison (pattern) de marques qui tient dans sa durée et ne contient
+ pas deux marques concurrentes. Problème maître, variables z_p :
+    max sum_p v_p z_p
+    sum_p (dépense de j dans p) z_p <= BUDGET_j     (dual lambda_j)
+    sum_(p de l'écran i) z_p <= 1                   (dual sigma_i)
+ Le maître restreint ne contient que les colonnes déjà générées (au départ,
+ les combinaisons des allocations gloutonnes). Sa relaxation donne les
+ duales ; le sous-problème de chaque écran est le sac à dos de knapsack.h de
+ profits v_ij - lambda_j * c_ij * t_j, résolu en parallèle sur les écrans,
+ et toute combinaison de valeur > sigma_i entre dans le maître. Les mêmes
+ sacs à dos donnent à chaque tour la borne lagrangienne
+ sum_j lambda_j BUDGET_j + sum_i (valeur du sac à dos i), valide même si la
+ génération s'arrête avant convergence.
+
+ Les sacs à dos travaillent en secondes entières (durées des marques et de
+ l'écran arrondies vers le bas : c'est une relaxation). Avec des durées
+ fractionnaires, une combinaison choisie peut dépasser la durée réelle de
+ l'écran : elle est réparée (marques de plus petit profit retirées) avant
+ d'entrer dans le maître, qui n'a pas de ligne de durée, et la génération
+ ne se déclare plus convergée sur ce tour.
+
+ Une fois la génération terminée, le maître est résolu en nombres entiers
+ sur les colonnes générées (solution réalisable, sans garantie
+ d'optimalité : pas de branch-and-price).
+ */
+
+#ifndef COLGEN_H
+#define COLGEN_H
+
+#include <vector>
+#include "heuristic.h"
+#include "instance.h"
+#include "options.h"
+#include "solver.h"
+
+struct Colgen_Result {
+    double lp_value = 0;        // relaxation du dernier maître restreint
+    double upper_bound = 0;     // meilleure borne lagrangienne
+    bool converged = false;     // plus aucune colonne améliorante : lp_value est la borne du maître complet
+    Allocation allocation;      // solution entière sur les colonnes générées
+    Solve_Status status = Solve_Status::UNKNOWN;
+    int rounds = 0;
+    int nb_columns = 0;
+    double time = 0;            // secondes
+};
+
+// Maximise l'objectif avec le solveur opt.solver (opt.time_limit pour la
+// génération puis autant pour le maître entier, opt.threads pour les sacs
+// à dos, 0 = nombre de coeurs). starts : allocations réalisables, colonnes
+// initiales et solutions de départ du maître entier.
+// Lève std::runtime_error si la relaxation du maître échoue.
+Colgen_Result column_generation(const Instance& inst, const Options& opt, Objective objective,
+                                const std::vector<Allocation>& starts);
+
+#endif
@@ -0,0 +1,269 @@
+/*
+ Solveur CPLEX (Concert).
+ */
+
+#include "cplex_backend.h"
+
+ILOSTLBEGIN
+
+using namespace std;
+
+
+namespace {
+
+// Note le temps écoulé avant la première solution réalisable : appelé
+// régulièrement pendant le branch-and-bound, sans modifier la recherche.
+class Incumbent_Timer : public IloCplex::MIPInfoCallbackI {
+public:
+    Incumbent_Timer(IloEnv env, const double* start, double* first)
+        : IloCplex::MIPInfoCallbackI(env), start(start), first(first) {}
+
+protected:
+    void main() override {
+        if (*first < 0 && hasIncumbent()){
+            *first = getCplexTime() - *start;
+        }
+    }
+
+    IloCplex::CallbackI* duplicateCallback() const override {
+        return new (getEnv()) Incumbent_Timer(*this);
+    }
+
+private:
+    const double* start;
+    double* first;
+};
+
+// IloEnv du thread courant, terminé à la fin du thread
+IloEnv thread_env()
+{
+    struct Holder {
+        IloEnv env;
+        ~Holder() { env.end(); }
+    };
+    thread_local Holder holder;
+    return holder.env;
+}
+
+IloNum bound(double b)
+{
+    return b <= -SOLVER_INFINITY ? -IloInfinity : b >= SOLVER_INFINITY ? IloInfinity : b;
+}
+
+Solve_Status status_of(IloAlgorithm::Status status)
+{
+    switch (status){
+        case IloAlgorithm::Optimal:                 return Solve_Status::OPTIMAL;
+        case IloAlgorithm::Feasible:                return Solve_Status::FEASIBLE;
+        case IloAlgorithm::Infeasible:
+        case IloAlgorithm::InfeasibleOrUnbounded:   return Solve_Status::INFEASIBLE;
+        case IloAlgorithm::Unbounded:               return Solve_Status::UNBOUNDED;
+        default:                                    return Solve_Status::UNKNOWN;
+    }
+}
+
+vector<double> to_vector(const IloNumArray& vals)
+{
+    vector<double> res(vals.getSize());
+    for (IloInt k = 0; k < vals.getSize(); k++){
+        res[k] = vals[k];
+    }
+    return res;
+}
+
+}
+
+
+Cplex_Backend::Cplex_Backend(const Options& opt)
+    : env(thread_env()), model(env), vars(env), rows(env), cplex(env)
+{
+    objective = IloMaximize(env);
+    model.add(objective);
+
+    // PARAMETRAGE DU SOLVEUR
+    cplex.setParam(IloCplex::Threads, opt.threads);
+    cplex.setParam(IloCplex::SimDisplay, 1);
+    cplex.setParam(IloCplex::TiLim, opt.time_limit);
+    incumbent_timer = cplex.use(IloCplex::Callback(new (env) Incumbent_Timer(env, &solve_start, &first_incumbent)));
+}
+
+
+Cplex_Backend::~Cplex_Backend()
+{
+    // L'IloEnv est partagé : seuls les objets de ce modèle sont libérés
+    cplex.end();
+    incumbent_timer.end();
+    model.end();
+    objective.end();
+    rows.endElements();
+    rows.end();
+    vars.endElements();
+    vars.end();
+}
+
+
+void Cplex_Backend::extract()
+{
+    // Extraction unique, une fois toutes les lignes ajoutées ; les
+    // modifications suivantes sont transmises à CPLEX par Concert
+    if (!extracted){
+        cplex.extract(model);
+        extracted = true;
+    }
+}
+
+
+void Cplex_Backend::add_variables(int n)
+{
+    for (int k = 0; k < n; k++){
+        vars.add(IloNumVar(env, 0, 1, ILOBOOL));
+    }
+}
+
+
+void Cplex_Backend::add_continuous_variables(int n, double ub)
+{
+    for (int k = 0; k < n; k++){
+        vars.add(IloNumVar(env, 0, bound(ub), ILOFLOAT));
+    }
+}
+
+
+void Cplex_Backend::add_integer_variables(int n, int ub)
+{
+    for (int k = 0; k < n; k++){
+        vars.add(IloNumVar(env, 0, ub, ILOINT));
+    }
+}
+
+
+int Cplex_Backend::add_row(const vector<int>& row_vars, const vector<double>& coefs, double lb, double ub)
+{
+    IloExpr expr(env);
+    for (size_t k = 0; k < row_vars.size(); k++){
+        expr += vars[row_vars[k]] * coefs[k];
+    }
+    IloRange row(env, bound(lb), expr, bound(ub));
+    expr.end();
+    model.add(row);
+    rows.add(row);
+    return (int) rows.getSize() - 1;
+}
+
+
+void Cplex_Backend::set_row_bounds(int row, double lb, double ub)
+{
+    rows[row].setBounds(bound(lb), bound(ub));
+}
+
+
+int Cplex_Backend::add_column(double obj, const vector<int>& col_rows, const vector<double>& coefs)
+{
+    // la variable entre dans le modèle (et dans CPLEX s'il est déjà extrait)
+    // par l'objectif et les lignes de sa colonne
+    IloNumColumn column = objective(obj);
+    for (size_t k = 0; k < col_rows.size(); k++){
+        column += rows[col_rows[k]](coefs[k]);
+    }
+    vars.add(IloNumVar(column, 0, 1, ILOBOOL));
+    column.end();
+    return (int) vars.getSize() - 1;
+}
+
+
+void Cplex_Backend::set_objective(const vector<double>& coefs)
+{
+    IloExpr expr(env);
+    for (size_t k = 0; k < coefs.size(); k++){
+        if (coefs[k] != 0){
+            expr += vars[k] * coefs[k];
+        }
+    }
+    objective.setExpr(expr);
+    expr.end();
+}
+
+
+void Cplex_Backend::add_start(const vector<double>& values, bool keep)
+{
+    extract();
+
+    // un seul start non gardé : celui de la résolution précédente
+    if (cplex.getNMIPStarts() > nb_kept_starts){
+        cplex.deleteMIPStarts(nb_kept_starts, cplex.getNMIPStarts() - nb_kept_starts);
+    }
+
+    // les starts qui violent une ligne (nouvelle borne d'epsilon) sont réparés
+    IloNumArray vals(env);
+    for (double v : values){
+        vals.add(v);
+    }
+    cplex.addMIPStart(vars, vals, IloCplex::MIPStartRepair);
+    vals.end();
+
+    if (keep){
+        nb_kept_starts++;
+    }
+}
+
+
+Solve_Status Cplex_Backend::solve()
+{
+    extract();
+
+    first_incumbent = -1;
+    solve_start = cplex.getCplexTime();
+    bool ok = cplex.solve();
+
+    solution.clear();
+    if (ok){
+        // Résolu sans passer par le callback (présolve) : first_incumbent
+        // reste à -1, le temps total n'est pas celui d'une première solution
+        objective_val = cplex.getObjValue();
+        IloNumArray vals(env);
+        cplex.getValues(vals, vars);
+        solution = to_vector(vals);
+        vals.end();
+    }
+    return status_of(cplex.getStatus());
+}
+
+
+Solve_Status Cplex_Backend::solve_relaxation()
+{
+    extract();
+
+    // variables continues le temps de cette résolution
+    IloConversion relax(env, vars, ILOFLOAT);
+    model.add(relax);
+    bool ok = cplex.solve();
+
+    solution.clear();
+    row_duals.clear();
+    if (ok){
+        objective_val = cplex.getObjValue();
+        IloNumArray vals(env);
+        cplex.getValues(vals, vars);
+        solution = to_vector(vals);
+        cplex.getDuals(vals, rows);
+        row_duals = to_vector(vals);
+        vals.end();
+    }
+    Solve_Status status = status_of(cplex.getStatus());
+    model.remove(relax);
+    relax.end();
+    return status;
+}
+
+
+void Cplex_Backend::export_model(const string& path)
+{
+    extract();
+    cplex.exportModel(path.c_str());
+}
+
+
+void Cplex_Backend::quiet()
+{
+    cplex.setOut(env.getNullStream());
+}
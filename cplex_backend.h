@@ -0,0 +1,84 @@
+/*
+ Solveur CPLEX (Concert).
+
+ Les modèles d'un même thread partagent un IloEnv, créé à la première
+ construction et terminé à la fin du thread : toutes les instances d'un
+ lot, résolues l'une après l'autre, utilisent le même. Les objets Concert
+ d'un IloEnv ne pouvant être modifiés que par un thread à la fois, chaque
+ thread des résolutions parallèles a le sien. Un modèle libère ses objets
+ à sa destruction, l'IloEnv reste.
+
+ Limite : l'IloEnv vit autant que son thread. Un thread créé pour une seule
+ résolution paie donc la création d'un environnement et le libère en
+ sortant ; les boucles parallèles répétées gardent leurs threads pour tout
+ l'appel (worker_pool.h) : au plus un IloEnv par thread du groupe, libéré à
+ la fin de l'appel. Les threads qui ne résolvent que des sacs à dos
+ (relaxation lagrangienne, pricing de la génération de colonnes) n'en
+ créent pas.
+
+ Le modèle est extrait une seule fois ; les modifications (bornes des
+ lignes, objectif) sont transmises à CPLEX qui conserve ses structures
+ d'une résolution à l'autre.
+ */
+
+#ifndef CPLEX_BACKEND_H
+#define CPLEX_BACKEND_H
+
+#include <ilcplex/ilocplex.h>
+#include "solver.h"
+
+class Cplex_Backend : public Solver_Backend {
+public:
+    explicit Cplex_Backend(const Options& opt);
+    ~Cplex_Backend();
+
+    Cplex_Backend(const Cplex_Backend&) = delete;
+    Cplex_Backend& operator=(const Cplex_Backend&) = delete;
+
+    std::string name() const override { return "cplex"; }
+
+    void add_variables(int n) override;
+    void add_continuous_variables(int n, double ub) override;
+    void add_integer_variables(int n, int ub) override;
+    int add_row(const std::vector<int>& vars, const std::vector<double>& coefs,
+                double lb, double ub) override;
+    void set_row_bounds(int row, double lb, double ub) override;
+    int add_column(double obj, const std::vector<int>& rows, const std::vector<double>& coefs) override;
+    void set_objective(const std::vector<double>& coefs) override;
+    void add_start(const std::vector<double>& values, bool keep) override;
+
+    Solve_Status solve() override;
+    Solve_Status solve_relaxation() override;
+    std::vector<double> duals() const override { return row_duals; }
+
+    double objective_value() const override { return objective_val; }
+    std::vector<double> values() const override { return solution; }
+    double first_incumbent_time() const override { return first_incumbent; }
+
+    int nb_variables() const override { return (int) vars.getSize(); }
+    int nb_rows() const override { return (int) rows.getSize(); }
+
+    void export_model(const std::string& path) override;
+    void quiet() override;
+
+private:
+    IloEnv env;                 // IloEnv du thread, partagé
+    IloModel model;
+    IloNumVarArray vars;
+    IloRangeArray rows;
+    IloObjective objective;
+    IloCplex cplex;
+    IloCplex::Callback incumbent_timer;
+    bool extracted = false;
+
+    int nb_kept_starts = 0;
+    double solve_start = 0;
+    double first_incumbent = -1;
+    double objective_val = 0;
+    std::vector<double> solution;
+    std::vector<double> row_duals;
+
+    void extract();
+};
+
+#endif
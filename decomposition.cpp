@@ -0,0 +1,299 @@
+/*
+ Décomposition par station : coordination des budgets et groupe de threads.
+ */
+
+#include "decomposition.h"
+#include "model.h"
+#include "presolve.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <set>
+#include <thread>
+#include <tuple>
+
+using namespace std;
+
+
+namespace {
+
+const double BUDGET_EPS = 1e-6;
+const double DUAL_EPS = 1e-9;       // prix duaux égaux : rien à déplacer
+
+// Solution courante d'une station, restaurée quand un tour est annulé
+struct Station_State {
+    vector<double> x;               // allocation (sous-instance, m_s * n)
+    vector<double> share;           // b_sj
+    vector<double> spend;           // dépense de x par marque
+    vector<double> dual;            // mu_sj
+    double value = 0;
+    Solve_Status status = Solve_Status::UNKNOWN;
+};
+
+// Sous-problème d'une station
+struct Station {
+    vector<int> breaks;             // écrans de l'instance complète, dans l'ordre
+    Instance sub;                   // ses écrans, BUDGET_j = state.share[j]
+    vector<double> demand;          // d_sj
+    vector<double> mean_price;      // prix moyen d'un spot de j (formats qui tiennent)
+    Station_State state;
+};
+
+}
+
+
+Decomposition_Result decompose_stations(const Instance& inst, const Options& opt, Objective objective,
+                                        const Allocation& start)
+{
+    auto t0 = chrono::steady_clock::now();
+    int m = inst.nb_Com_Break, n = inst.nb_Brands;
+    bool by_grp = objective == Objective::GRP;
+
+    auto price = [&](int i, int j){ return (double) (inst.cost(i, j) * inst.brand_time[j]); };
+    auto value = [&](int i, int j){ return by_grp ? (double) inst.grp_of(i, j) : price(i, j); };
+
+    Decomposition_Result result;
+
+    // Stations par identifiant croissant
+    map<int, vector<int>> by_station;
+    for (int i = 0; i < m; i++){
+        by_station[inst.station[i]].push_back(i);
+    }
+    vector<Station> stations(by_station.size());
+    int S = 0;
+    for (auto& kv : by_station){
+        Station& st = stations[S++];
+        st.breaks = move(kv.second);
+        st.sub = inst.select_breaks(st.breaks);
+        int ms = (int) st.breaks.size();
+        st.demand.assign(n, 0);
+        st.mean_price.assign(n, 0);
+        Station_State& cur = st.state;
+        cur.x.assign((size_t) ms * n, 0);
+        cur.spend.assign(n, 0);
+        cur.dual.assign(n, 0);
+        for (int k = 0; k < ms; k++){
+            int i = st.breaks[k];
+            for (int j = 0; j < n; j++){
+                if (start.x[(size_t) i * n + j]){
+                    cur.x[(size_t) k * n + j] = 1;
+                    cur.spend[j] += price(i, j);
+                    cur.value += value(i, j);
+                }
+                if (inst.brand_time[j] <= inst.break_time[i]){
+                    st.demand[j] += price(i, j);
+                    st.mean_price[j]++;
+                }
+            }
+        }
+        for (int j = 0; j < n; j++){
+            st.mean_price[j] = st.mean_price[j] > 0 ? st.demand[j] / st.mean_price[j] : 0;
+        }
+    }
+    result.nb_stations = S;
+
+    // Parts initiales : dépense gloutonne, plus le reste au prorata de la
+    // demande (parts entières : les prix le sont)
+    for (int j = 0; j < n; j++){
+        double spent = 0, demand = 0;
+        for (const Station& st : stations){
+            spent += st.state.spend[j];
+            demand += st.demand[j];
+        }
+        double left = max(0.0, inst.budget_cap[j] - spent);
+        for (Station& st : stations){
+            double extra = demand > 0 ? floor(left * st.demand[j] / demand) : 0;
+            st.state.share.push_back(st.state.spend[j] + extra);
+        }
+    }
+
+    // Un sous-problème : modèle de la station avec ses parts, départ x s'il
+    // respecte encore les parts
+    Options sub_opt = opt;
+    sub_opt.threads = 1;
+    sub_opt.parallel = 0;
+    sub_opt.objectives = 2;
+    Options dual_opt = sub_opt;
+    dual_opt.presolve = false;
+    dual_opt.aggregate = false;
+
+    auto solve_station = [&](Station& st){
+        Station_State& cur = st.state;
+        int ms = st.sub.nb_Com_Break;
+        bool start_ok = true;
+        for (int j = 0; j < n; j++){
+            double cap = st.sub.set_budget(j, cur.share[j]);
+            start_ok &= cur.spend[j] <= cap + BUDGET_EPS;
+        }
+        if (!start_ok){
+            fill(cur.x.begin(), cur.x.end(), 0);
+            cur.value = 0;
+        }
+
+        Presolve pre = presolve(st.sub, sub_opt);
+        fill(cur.dual.begin(), cur.dual.end(), 0);
+        cur.status = Solve_Status::OPTIMAL;
+        if (pre.nb_vars() > 0){
+            Allocation_Model model(st.sub, sub_opt, pre);
+            model.quiet();
+            if (by_grp)
+                model.maximize_grp();
+            else
+                model.maximize_revenue();
+            if (opt.warm_start && start_ok)
+                model.add_start(model.to_model_values(cur.x), true);
+
+            // Une solution moins bonne que le départ (ignoré par le solveur
+            // natif) n'est pas gardée
+            if (model.solve() && (by_grp ? model.grp_value() : model.revenue_value()) >= cur.value - BUDGET_EPS)
+                cur.x = model.allocation_values();
+            cur.status = model.status();
+        }
+        else {
+            fill(cur.x.begin(), cur.x.end(), 0);
+        }
+
+        // Prix duaux sur le modèle complet : le presolve retire les couples
+        // au-delà de la part et les budgets qu'elle ne lie pas, donc
+        // justement la valeur d'un budget plus grand
+        Presolve full = presolve(st.sub, dual_opt);
+        if (full.nb_vars() > 0){
+            Allocation_Model relaxation(st.sub, dual_opt, full);
+            relaxation.quiet();
+            if (by_grp)
+                relaxation.maximize_grp();
+            else
+                relaxation.maximize_revenue();
+            cur.dual = relaxation.budget_duals();
+        }
+
+        fill(cur.spend.begin(), cur.spend.end(), 0);
+        cur.value = 0;
+        for (int k = 0; k < ms; k++){
+            for (int j = 0; j < n; j++){
+                if (cur.x[(size_t) k * n + j] > 0.5){
+                    cur.spend[j] += price(st.breaks[k], j);
+                    cur.value += value(st.breaks[k], j);
+                }
+            }
+        }
+    };
+
+    // Groupe de threads créé une fois pour la première résolution et tous
+    // les tours de coordination : un environnement CPLEX par thread
+    int nb_threads = opt.threads > 0 ? opt.threads : max(1u, thread::hardware_concurrency());
+    Worker_Pool pool(max(1, min(nb_threads, S)));
+
+    // Première résolution de toutes les stations, les plus grandes d'abord
+    vector<int> order(S);
+    for (int s = 0; s < S; s++){
+        order[s] = s;
+    }
+    sort(order.begin(), order.end(), [&](int a, int b){
+        return stations[a].breaks.size() > stations[b].breaks.size();
+    });
+    pool.run(S, [&](int k){ solve_station(stations[order[k]]); });
+    result.nb_solves += S;
+
+    // Maître : échanges de budget entre paires de stations. Pour chaque
+    // marque, chaque station receveuse, par prix dual décroissant, est
+    // appariée à la station de plus bas prix dual libre, qui cède le prix
+    // moyen d'un spot de la receveuse : le donneur est résolu avec sa part
+    // diminuée, puis la receveuse avec tout ce qu'il ne dépense plus. Les
+    // paires d'un tour sont disjointes et résolues ensemble ; un échange
+    // n'est gardé que si la valeur de la paire augmente, sinon il est
+    // écarté jusqu'au prochain échange gardé.
+    struct Exchange {
+        int j, donor, receiver;
+        double amount;
+    };
+    set<tuple<int, int, int>> rejected;
+    vector<Station_State> saved(S);
+    for (result.rounds = 1; result.rounds < opt.decompose; ){
+        vector<Exchange> moves;
+        vector<char> busy(S, 0);
+        for (int j = 0; j < n; j++){
+            order.clear();
+            for (int s = 0; s < S; s++){
+                if (!busy[s] && stations[s].demand[j] > 0)
+                    order.push_back(s);
+            }
+            sort(order.begin(), order.end(), [&](int a, int b){
+                return stations[a].state.dual[j] > stations[b].state.dual[j];
+            });
+            for (int a = 0; a < (int) order.size(); a++){
+                int r = order[a];
+                double mu = stations[r].state.dual[j];
+                for (int b = (int) order.size() - 1; b > a && !busy[r]; b--){
+                    int d = order[b];
+                    if (mu <= stations[d].state.dual[j] + DUAL_EPS * max(1.0, mu))
+                        break;
+                    double amount = floor(min(stations[d].state.share[j], stations[r].mean_price[j]));
+                    if (busy[d] || amount < 1 || rejected.count(make_tuple(j, d, r)))
+                        continue;
+                    moves.push_back({ j, d, r, amount });
+                    busy[d] = busy[r] = 1;
+                }
+            }
+        }
+        if (moves.empty())
+            break;
+
+        for (const Exchange& e : moves){
+            saved[e.donor] = stations[e.donor].state;
+            saved[e.receiver] = stations[e.receiver].state;
+        }
+        pool.run((int) moves.size(), [&](int k){
+            const Exchange& e = moves[k];
+            Station_State& d = stations[e.donor].state;
+            Station_State& r = stations[e.receiver].state;
+            d.share[e.j] -= e.amount;
+            solve_station(stations[e.donor]);
+            r.share[e.j] += e.amount + d.share[e.j] - d.spend[e.j];
+            d.share[e.j] = d.spend[e.j];
+            solve_station(stations[e.receiver]);
+        });
+        result.nb_solves += 2 * (int) moves.size();
+        result.rounds++;
+
+        bool kept = false;
+        for (const Exchange& e : moves){
+            Station_State& d = stations[e.donor].state;
+            Station_State& r = stations[e.receiver].state;
+            if (d.value + r.value > saved[e.donor].value + saved[e.receiver].value + BUDGET_EPS){
+                kept = true;
+                result.nb_exchanges++;
+            }
+            else {
+                d = saved[e.donor];
+                r = saved[e.receiver];
+                rejected.insert(make_tuple(e.j, e.donor, e.receiver));
+            }
+        }
+        if (kept)
+            rejected.clear();
+    }
+
+    // Juxtaposition des allocations des stations
+    Allocation& alloc = result.allocation;
+    alloc.x.assign((size_t) m * n, 0);
+    for (const Station& st : stations){
+        for (int k = 0; k < (int) st.breaks.size(); k++){
+            int i = st.breaks[k];
+            for (int j = 0; j < n; j++){
+                if (st.state.x[(size_t) k * n + j] > 0.5){
+                    alloc.x[(size_t) i * n + j] = 1;
+                    alloc.revenue += price(i, j);
+                    alloc.grp += inst.grp_of(i, j);
+                    alloc.nb_spots++;
+                }
+            }
+        }
+        result.nb_optimal += st.state.status == Solve_Status::OPTIMAL;
+    }
+    result.time = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    return result;
+}
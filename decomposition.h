@@ -0,0 +1,62 @@
+/*
+ Décomposition par station.
+
+ Les écrans d'une station ne partagent avec ceux des autres stations que
+ les budgets des marques : une fois BUDGET_j réparti en parts b_sj
+ (sum_s b_sj <= BUDGET_j), chaque station est un problème indépendant, le
+ modèle exact (presolve compris) restreint à ses écrans avec BUDGET_j = b_sj.
+ Les sous-problèmes sont résolus simultanément par un groupe de threads
+ (un solveur par thread), les plus grands d'abord, et leurs allocations
+ sont juxtaposées. Le groupe est créé une fois par appel et sert à tous les
+ tours de coordination (worker_pool.h).
+
+ Coordination des parts (maître par directives de ressources) :
+    - départ : la dépense de l'allocation gloutonne dans chaque station,
+      plus le budget qu'elle laisse, réparti selon la demande d_sj (coût de
+      tous les écrans de s où le format de j tient) ; l'allocation gloutonne
+      restreinte à la station reste réalisable et sert de MIP start ;
+    - chaque sous-problème donne, par la relaxation linéaire de son modèle
+      complet (sans presolve : celui-ci retire justement les couples et
+      les budgets au-delà de la part), le prix dual mu_sj de son budget ;
+    - maître : à chaque tour, pour chaque marque, les stations de mu_sj
+      élevé sont appariées à celles de mu_sj plus bas, qui leur cèdent le
+      prix moyen d'un spot de la receveuse. Les prix sont gros et
+      entiers : un déplacement continu le long du sous-gradient supprime
+      des spots entiers sans en payer d'autres, d'où ces échanges d'un
+      spot. Les paires d'un tour sont disjointes et résolues ensemble ; un
+      échange n'est gardé que si la valeur de la paire augmente.
+ Les parts restent entières (les prix le sont) et leur somme au plus
+ BUDGET_j ; le budget d'un sous-problème est sa part arrondie vers le bas
+ au float (Instance::set_budget) : toute combinaison des solutions des
+ stations est réalisable, et
+ la valeur totale ne diminue jamais. La coordination s'arrête après
+ opt.decompose tours de résolution, ou quand plus aucun échange n'est à
+ essayer. Pas de garantie d'optimalité globale : les prix duaux des
+ relaxations n'estiment que la valeur marginale des budgets en nombres
+ entiers.
+ */
+
+#ifndef DECOMPOSITION_H
+#define DECOMPOSITION_H
+
+#include "heuristic.h"
+#include "instance.h"
+#include "options.h"
+
+struct Decomposition_Result {
+    Allocation allocation;      // juxtaposition des allocations des stations
+    int nb_stations = 0;
+    int rounds = 0;             // tours de résolution des stations
+    int nb_exchanges = 0;       // échanges de budget gardés
+    int nb_solves = 0;          // résolutions de sous-problèmes
+    int nb_optimal = 0;         // stations dont la dernière résolution est optimale
+    double time = 0;            // secondes
+};
+
+// Maximise l'objectif station par station (opt.time_limit par résolution,
+// opt.threads sous-problèmes simultanés, 0 = nombre de coeurs ; un thread
+// par solveur). start : allocation réalisable de l'instance complète.
+Decomposition_Result decompose_stations(const Instance& inst, const Options& opt, Objective objective,
+                                        const Allocation& start);
+
+#endif
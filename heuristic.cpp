@@ -0,0 +1,133 @@
+/*
+ Heuristique gloutonne d'allocation.
+ */
+
+#include "heuristic.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+using namespace std;
+
+
+const char* rule_name(Greedy_Rule rule)
+{
+    return rule == Greedy_Rule::GRP_PER_SECOND ? "GRP/s" : "revenu/s";
+}
+
+
+Allocation greedy_allocation(const Instance& inst, Greedy_Rule rule)
+{
+    int nb_Com_Break = inst.nb_Com_Break;
+    int nb_Brands = inst.nb_Brands;
+    int nb_Types = inst.nb_Types();
+    bool by_grp = rule == Greedy_Rule::GRP_PER_SECOND;
+
+    // Clé d'un couple : critère principal, puis l'autre critère, puis le
+    // numéro du couple. L'ordre global des m * n couples n'est pas construit :
+    // pour une marque, l'ordre des écrans ne dépend que de son audience
+    // (grp_ij / t_j et c_ij varient comme grp[a][i] et c_i). On trie donc les
+    // écrans une fois par audience, puis on fusionne les listes des marques
+    // avec un tas, ce qui donne exactement l'ordre global.
+    auto key = [&](int i, int j){
+        float t = inst.brand_time[j];
+        float grp_s = t > 0 ? inst.grp_of(i, j) / t : inst.grp_of(i, j);
+        float revenue_s = inst.cost(i, j);
+        return make_tuple(by_grp ? grp_s : revenue_s, by_grp ? revenue_s : grp_s, -((int64_t) i * nb_Brands + j));
+    };
+
+    vector<vector<int>> audience_order(inst.nb_Audiences());
+    for (int a = 0; a < inst.nb_Audiences(); a++){
+        const Column<float>& g = inst.grp[a];
+        vector<int>& order = audience_order[a];
+        order.resize(nb_Com_Break);
+        for (int i = 0; i < nb_Com_Break; i++){
+            order[i] = i;
+        }
+        sort(order.begin(), order.end(), [&](int i1, int i2){
+            float g1 = g[i1], g2 = g[i2];
+            float c1 = inst.cost(i1, 0), c2 = inst.cost(i2, 0);
+            if (by_grp){
+                if (g1 != g2) return g1 > g2;
+                if (c1 != c2) return c1 > c2;
+            }
+            else {
+                if (c1 != c2) return c1 > c2;
+                if (g1 != g2) return g1 > g2;
+            }
+            return i1 < i2;
+        });
+    }
+
+    vector<double> remaining_time(nb_Com_Break);
+    float min_cost = numeric_limits<float>::max();
+    for (int i = 0; i < nb_Com_Break; i++){
+        remaining_time[i] = inst.break_time[i];
+        min_cost = min(min_cost, inst.cost(i, 0));
+    }
+    vector<double> remaining_budget(nb_Brands);
+    for (int j = 0; j < nb_Brands; j++){
+        remaining_budget[j] = inst.budget_cap[j];
+    }
+    // type déjà présent sur l'écran : matrice m * nb_Types
+    vector<uint8_t> type_used((size_t) nb_Com_Break * nb_Types, 0);
+
+    // position de chaque marque dans la liste des écrans de son audience
+    vector<int> next(nb_Brands, 0);
+    auto current = [&](int j){ return audience_order[inst.brand_audience[j]][next[j]]; };
+    auto lower = [&](int j1, int j2){ return key(current(j1), j1) < key(current(j2), j2); };
+    vector<int> heap;
+    for (int j = 0; j < nb_Brands; j++){
+        if (nb_Com_Break > 0){
+            heap.push_back(j);
+        }
+    }
+    make_heap(heap.begin(), heap.end(), lower);
+
+    Allocation alloc;
+    alloc.x.assign((size_t) nb_Com_Break * nb_Brands, 0);
+    while (!heap.empty()){
+        pop_heap(heap.begin(), heap.end(), lower);
+        int j = heap.back();
+        int i = current(j);
+
+        double t = inst.brand_time[j];
+        // même calcul que le coefficient du modèle
+        double price = inst.cost(i, j) * inst.brand_time[j];
+        uint8_t& used = type_used[(size_t) i * nb_Types + inst.brand_type[j]];
+        if (!used && t <= remaining_time[i] && price <= remaining_budget[j]){
+            used = 1;
+            remaining_time[i] -= t;
+            remaining_budget[j] -= price;
+            alloc.x[(size_t) i * nb_Brands + j] = 1;
+            alloc.revenue += price;
+            alloc.grp += inst.grp_of(i, j);
+            alloc.nb_spots++;
+        }
+
+        next[j]++;
+        if (!by_grp && price > remaining_budget[j]){
+            // écrans triés par prix décroissant : on saute ceux trop chers
+            const vector<int>& order = audience_order[inst.brand_audience[j]];
+            next[j] = (int) (partition_point(order.begin() + next[j], order.end(), [&](int i2){
+                return inst.cost(i2, j) * inst.brand_time[j] > remaining_budget[j];
+            }) - order.begin());
+        }
+
+        // marque épuisée : plus d'écran, ou plus de budget pour le moins cher
+        if (next[j] < nb_Com_Break && remaining_budget[j] >= (double) (min_cost * inst.brand_time[j])){
+            push_heap(heap.begin(), heap.end(), lower);
+        }
+        else {
+            heap.pop_back();
+        }
+    }
+    return alloc;
+}
+
+
+vector<double> to_values(const Allocation& alloc)
+{
+    return vector<double>(alloc.x.begin(), alloc.x.end());
+}
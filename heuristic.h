@@ -0,0 +1,46 @@
+/*
+ Heuristique gloutonne d'allocation.
+
+ Les couples (écran, marque) sont classés par GRP par seconde
+ (grp_ij / t_j) ou par revenu par seconde (c_ij), puis pris dans cet ordre
+ tant qu'ils respectent la durée restante de l'écran, le budget restant de la
+ marque et l'exclusion des marques concurrentes (au plus une marque de
+ chaque type par écran). Le résultat est réalisable pour le modèle exact
+ sans epsilon-contrainte : il sert de réponse immédiate (re-planification)
+ et de MIP start des résolutions exactes.
+ */
+
+#ifndef HEURISTIC_H
+#define HEURISTIC_H
+
+#include <cstdint>
+#include <vector>
+#include "instance.h"
+
+enum class Greedy_Rule {
+    GRP_PER_SECOND,
+    REVENUE_PER_SECOND
+};
+
+const char* rule_name(Greedy_Rule rule);
+
+// Objectif maximisé par la recherche locale et les bornes lagrangiennes
+enum class Objective {
+    REVENUE,
+    GRP
+};
+
+// Allocation x_ij (matrice m * n, ligne i contiguë) et ses objectifs
+struct Allocation {
+    std::vector<uint8_t> x;
+    double revenue = 0;
+    double grp = 0;
+    int nb_spots = 0;
+};
+
+Allocation greedy_allocation(const Instance& inst, Greedy_Rule rule);
+
+// x_ij en double, à plat : solution de départ du modèle exact
+std::vector<double> to_values(const Allocation& alloc);
+
+#endif
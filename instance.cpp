@@ -0,0 +1,144 @@
+/*
+ Instance du problème : gestion des colonnes et données dérivées.
+ */
+
+#include "instance.h"
+
+#include <cmath>
+
+using namespace std;
+
+
+void Instance::reserve_break(int i)
+{
+    if (i < nb_Com_Break){
+        return;
+    }
+    nb_Com_Break = i + 1;
+    break_time.resize(nb_Com_Break, 0);
+    prime_break.resize(nb_Com_Break, 0);
+    station.resize(nb_Com_Break, 0);
+    start_date.resize(nb_Com_Break, 0);
+    delay.resize(nb_Com_Break, 0);
+    for (auto& col : grp){
+        col.resize(nb_Com_Break, 0);
+    }
+    for (int s = 0; s < NB_SLOTS; s++){
+        slot_price[s].resize(nb_Com_Break, 0);
+        slot_available[s].resize(nb_Com_Break, 0);
+    }
+}
+
+
+int Instance::audience_id(const string& name)
+{
+    int a = audiences.intern(name);
+    if (a == (int) grp.size()){
+        grp.emplace_back(nb_Com_Break, 0.0f);
+    }
+    return a;
+}
+
+
+void Instance::reserve_brand(int j)
+{
+    if (j < nb_Brands){
+        return;
+    }
+    nb_Brands = j + 1;
+    brand_type.resize(nb_Brands, 0);
+    brand_audience.resize(nb_Brands, 0);
+    brand_time.resize(nb_Brands, 0);
+    grp_cap.resize(nb_Brands, 0);
+    budget_cap.resize(nb_Brands, 0);
+    prime.resize(nb_Brands, 0);
+    premium.resize(nb_Brands, 0);
+    priority.resize(nb_Brands, 0);
+}
+
+
+void Instance::build_grp_ij()
+{
+    int A = nb_Audiences();
+    grp_ij = Column<float>((size_t) nb_Com_Break * nb_Brands);
+
+    vector<float> grp_i(A);
+    for (int i = 0; i < nb_Com_Break; i++){
+        for (int a = 0; a < A; a++){
+            grp_i[a] = grp[a][i];
+        }
+        float* row = grp_ij.data() + (size_t) i * nb_Brands;
+        for (int j = 0; j < nb_Brands; j++){
+            row[j] = grp_i[brand_audience[j]];
+        }
+    }
+}
+
+
+void Instance::build_type_groups()
+{
+    int T = nb_Types();
+
+    // tri par dénombrement des marques selon leur type
+    type_start = Column<int>(T + 1, 0);
+    for (int j = 0; j < nb_Brands; j++){
+        type_start[brand_type[j] + 1]++;
+    }
+    for (int t = 0; t < T; t++){
+        type_start[t + 1] += type_start[t];
+    }
+
+    type_brands = Column<int>(nb_Brands);
+    vector<int> next(type_start.begin(), type_start.end() - 1);
+    for (int j = 0; j < nb_Brands; j++){
+        type_brands[next[brand_type[j]]++] = j;
+    }
+}
+
+
+Instance Instance::select_breaks(const vector<int>& breaks) const
+{
+    Instance sub;
+    sub.audiences = audiences;
+    sub.types = types;
+    sub.grp.resize(grp.size());
+    sub.reserve_break((int) breaks.size() - 1);
+    for (int k = 0; k < sub.nb_Com_Break; k++){
+        int i = breaks[k];
+        sub.break_time[k] = break_time[i];
+        sub.prime_break[k] = prime_break[i];
+        sub.station[k] = station[i];
+        sub.start_date[k] = start_date[i];
+        sub.delay[k] = delay[i];
+        for (int a = 0; a < nb_Audiences(); a++){
+            sub.grp[a][k] = grp[a][i];
+        }
+        for (int s = 0; s < NB_SLOTS; s++){
+            sub.slot_price[s][k] = slot_price[s][i];
+            sub.slot_available[s][k] = slot_available[s][i];
+        }
+    }
+    sub.brand_type = brand_type;
+    sub.brand_audience = brand_audience;
+    sub.brand_time = brand_time;
+    sub.grp_cap = grp_cap;
+    sub.budget_cap = budget_cap;
+    sub.prime = prime;
+    sub.premium = premium;
+    sub.priority = priority;
+    sub.nb_Brands = nb_Brands;
+    sub.build_grp_ij();
+    sub.build_type_groups();
+    return sub;
+}
+
+
+double Instance::set_budget(int j, double budget)
+{
+    float b = (float) budget;
+    if (b > budget){
+        b = nextafter(b, -INFINITY);
+    }
+    budget_cap[j] = b;
+    return b;
+}
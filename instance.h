@@ -0,0 +1,271 @@
+/*
+ Instance du problème d'allocation de spots publicitaires.
+
+ Les données sont rangées en colonnes (structure de tableaux) allouées sur le
+ tas et alignées sur une ligne de cache : une colonne par attribut des écrans
+ (i), une par attribut des marques (j), une par audience pour les GRP et une
+ par position (normal_1 .. normal_5) pour les prix et disponibilités.
+ Les constructeurs de modèle et les heuristiques parcourent ces colonnes
+ directement.
+ */
+
+#ifndef INSTANCE_H
+#define INSTANCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Nombre de positions vendables par écran (normal_1 .. normal_5)
+const int NB_SLOTS = 5;
+
+// Alignement des colonnes (ligne de cache)
+const size_t COLUMN_ALIGN = 64;
+
+
+// Tableau contigu de valeurs simples, aligné sur COLUMN_ALIGN.
+// Une colonne possède sa mémoire, ou bien est une vue sur une zone détenue par
+// "owner" (fichier projeté en mémoire, voir cache.h) ; une vue redimensionnée
+// est d'abord recopiée dans une mémoire propre.
+template <typename T>
+class Column {
+    static_assert(std::is_trivially_copyable<T>::value, "Column ne contient que des types simples");
+
+public:
+    Column() {}
+    explicit Column(size_t n, T value = T()) { resize(n, value); }
+
+    Column(const Column& other) { *this = other; }
+    Column(Column&& other) noexcept { swap(other); }
+    ~Column() { release(); }
+
+    // Vue sans copie sur n valeurs à l'adresse p, maintenues en vie par owner
+    static Column view(T* p, size_t n, std::shared_ptr<void> owner)
+    {
+        Column col;
+        col.ptr = p;
+        col.n = col.cap = n;
+        col.owner = std::move(owner);
+        return col;
+    }
+
+    bool is_view() const { return (bool) owner; }
+
+    Column& operator=(const Column& other)
+    {
+        if (this != &other){
+            if (owner){
+                release();
+            }
+            clear();
+            reserve(other.n);
+            for (size_t k = 0; k < other.n; k++){
+                ptr[k] = other.ptr[k];
+            }
+            n = other.n;
+        }
+        return *this;
+    }
+
+    Column& operator=(Column&& other) noexcept
+    {
+        if (this != &other){
+            release();
+            swap(other);
+        }
+        return *this;
+    }
+
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+
+    T* data() { return ptr; }
+    const T* data() const { return ptr; }
+
+    T& operator[](size_t k) { return ptr[k]; }
+    const T& operator[](size_t k) const { return ptr[k]; }
+
+    T* begin() { return ptr; }
+    T* end() { return ptr + n; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + n; }
+
+    void reserve(size_t c)
+    {
+        if (c <= cap){
+            return;
+        }
+        T* p = static_cast<T*>(::operator new(c * sizeof(T), std::align_val_t(COLUMN_ALIGN)));
+        for (size_t k = 0; k < n; k++){
+            p[k] = ptr[k];
+        }
+        size_t old_n = n;
+        release();
+        ptr = p;
+        n = old_n;
+        cap = c;
+    }
+
+    // Agrandissement géométrique : les chargeurs en flux redimensionnent écran par écran
+    void resize(size_t new_n, T value = T())
+    {
+        if (new_n > cap){
+            reserve(new_n > 2 * cap ? new_n : 2 * cap);
+        }
+        for (size_t k = n; k < new_n; k++){
+            ptr[k] = value;
+        }
+        n = new_n;
+    }
+
+    void push_back(T value) { resize(n + 1, value); }
+
+    void clear() { n = 0; }
+
+    void swap(Column& other) noexcept
+    {
+        std::swap(ptr, other.ptr);
+        std::swap(n, other.n);
+        std::swap(cap, other.cap);
+        owner.swap(other.owner);
+    }
+
+private:
+    void release()
+    {
+        if (owner){
+            owner.reset();
+        }
+        else if (ptr){
+            ::operator delete(ptr, std::align_val_t(COLUMN_ALIGN));
+        }
+        ptr = nullptr;
+        n = cap = 0;
+    }
+
+    T* ptr = nullptr;
+    size_t n = 0;
+    size_t cap = 0;
+    std::shared_ptr<void> owner;
+};
+
+
+// Table d'internement : associe à chaque nom un petit identifiant entier
+// (0, 1, 2, ... dans l'ordre d'apparition)
+struct Name_Table {
+    std::vector<std::string> names;
+    std::unordered_map<std::string, int> ids;
+
+    int size() const { return (int) names.size(); }
+
+    // Identifiant de "name", -1 s'il est inconnu
+    int find(const std::string& name) const
+    {
+        auto it = ids.find(name);
+        return it == ids.end() ? -1 : it->second;
+    }
+
+    // Identifiant de "name", créé s'il est inconnu
+    int intern(const std::string& name)
+    {
+        auto it = ids.emplace(name, size());
+        if (it.second){
+            names.push_back(name);
+        }
+        return it.first->second;
+    }
+};
+
+
+struct Instance {
+    int nb_Com_Break = 0;   // m
+    int nb_Brands = 0;      // n
+
+    // ECRANS (colonnes de taille m)
+    Column<float> break_time;       // T_i
+    Column<int> prime_break;        // fp(i)
+    Column<int> station;            // station_name
+    Column<int64_t> start_date;     // début de l'écran, secondes depuis 1970 (UTC)
+    Column<int> delay;
+
+    Name_Table audiences;                       // man_13-34, woman_34-65, ... -> identifiant a
+    std::vector<Column<float>> grp;             // grp[a][i] : GRP de l'écran i pour l'audience a
+
+    Column<int> slot_price[NB_SLOTS];           // slot_price[s][i]
+    Column<uint8_t> slot_available[NB_SLOTS];   // slot_available[s][i]
+
+    // MARQUES (colonnes de taille n)
+    Name_Table types;                           // cosmetic, cars, ... -> identifiant t
+    Column<int> brand_type;         // identifiant du type de la marque
+    Column<int> brand_audience;     // identifiant de l'audience visée
+    Column<float> brand_time;       // t_j
+    Column<float> grp_cap;          // GRP_j
+    Column<float> budget_cap;       // BUDGET_j
+    Column<float> prime;            // PRIME_j
+    Column<float> premium;          // ratio_premium
+    Column<float> priority;         // PRIORITY_j (absent des données -> 0)
+
+    // GROUPES DE MARQUES CONCURRENTES (même type), format compressé :
+    // les marques du type t sont type_brands[type_start[t] .. type_start[t+1]-1]
+    Column<int> type_start;         // taille nb_Types() + 1
+    Column<int> type_brands;        // taille n, marques triées par type
+
+    // COUPLES (écran, marque) : matrice m * n, ligne i contiguë
+    Column<float> grp_ij;           // grp_ij
+
+    int nb_Audiences() const { return audiences.size(); }
+    int nb_Types() const { return types.size(); }
+
+    // Identifiant de l'audience "name", -1 si elle est inconnue
+    int audience_index(const std::string& name) const { return audiences.find(name); }
+
+    // Identifiant de l'audience "name" ; une audience inconnue reçoit une
+    // colonne de GRP nulle
+    int audience_id(const std::string& name);
+
+    // c_ij : prix de la position normal_1 de l'écran
+    float cost(int i, int) const { return (float) slot_price[0][i]; }
+
+    // Prix de la position s (normal_1 .. normal_5) de l'écran i
+    float slot_cost(int i, int s) const { return (float) slot_price[s][i]; }
+
+    float grp_of(int i, int j) const { return grp_ij[(size_t) i * nb_Brands + j]; }
+
+    // fc(j1,j2) : marques concurrentes
+    bool competitors(int j1, int j2) const { return brand_type[j1] == brand_type[j2]; }
+
+    // Marques du type t : [type_begin(t), type_end(t)[
+    const int* type_begin(int t) const { return type_brands.data() + type_start[t]; }
+    const int* type_end(int t) const { return type_brands.data() + type_start[t + 1]; }
+    int type_size(int t) const { return type_start[t + 1] - type_start[t]; }
+
+    // Redimensionne les colonnes des écrans pour contenir l'écran i
+    void reserve_break(int i);
+
+    // Redimensionne les colonnes des marques pour contenir la marque j
+    void reserve_brand(int j);
+
+    // Remplit grp_ij : pour chaque écran, on lit une fois son vecteur de GRP
+    // par audience puis on le distribue selon brand_audience (aucune
+    // comparaison de chaînes)
+    void build_grp_ij();
+
+    // Remplit type_start / type_brands à partir de brand_type
+    void build_type_groups();
+
+    // Sous-instance des écrans breaks (dans cet ordre : l'écran k de la
+    // sous-instance est breaks[k]) avec toutes les marques ; grp_ij et les
+    // groupes de types sont reconstruits
+    Instance select_breaks(const std::vector<int>& breaks) const;
+
+    // BUDGET_j = budget, arrondi vers le bas au float représentable : le
+    // budget fixé ne dépasse jamais celui demandé. Renvoie la valeur fixée.
+    double set_budget(int j, double budget);
+};
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ Sac à dos d'un écran par programmation dynamique vectorisée.
+ */
+
+#include "knapsack.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+
+const char* knapsack_isa()
+{
+#if defined(__AVX512F__)
+    return "AVX-512";
+#elif defined(__AVX2__)
+    return "AVX2";
+#else
+    return "scalaire";
+#endif
+}
+
+
+// cur[c] = max(cur[c], prev[c - w] + profit) pour c de w à C
+static void relax_scalar(double* cur, const double* prev, int C, int w, double profit)
+{
+    for (int c = w; c <= C; c++){
+        cur[c] = max(cur[c], prev[c - w] + profit);
+    }
+}
+
+static void relax_vectorized(double* cur, const double* prev, int C, int w, double profit)
+{
+    int c = w;
+#if defined(__AVX512F__)
+    __m512d p8 = _mm512_set1_pd(profit);
+    for (; c + 8 <= C + 1; c += 8){
+        __m512d v = _mm512_add_pd(_mm512_loadu_pd(prev + c - w), p8);
+        _mm512_storeu_pd(cur + c, _mm512_max_pd(_mm512_loadu_pd(cur + c), v));
+    }
+#endif
+#if defined(__AVX2__)
+    __m256d p4 = _mm256_set1_pd(profit);
+    for (; c + 4 <= C + 1; c += 4){
+        __m256d v = _mm256_add_pd(_mm256_loadu_pd(prev + c - w), p4);
+        _mm256_storeu_pd(cur + c, _mm256_max_pd(_mm256_loadu_pd(cur + c), v));
+    }
+#endif
+    // reste (ou tout, sans AVX)
+    for (; c <= C; c++){
+        cur[c] = max(cur[c], prev[c - w] + profit);
+    }
+}
+
+
+void Break_Knapsack::clear()
+{
+    items.clear();
+    group_start.clear();
+}
+
+
+void Break_Knapsack::begin_group()
+{
+    group_start.push_back((int) items.size());
+}
+
+
+void Break_Knapsack::add_item(int id, int w, double profit)
+{
+    items.push_back({ id, w, profit });
+}
+
+
+double Break_Knapsack::solve(int C)
+{
+    selection.clear();
+    if (C < 0){
+        return 0;
+    }
+
+    // Compactage : items utiles seulement, groupes non vides ; le meilleur
+    // item de chaque groupe est placé en tête
+    int nb_groups = (int) group_start.size();
+    group_start.push_back((int) items.size());
+    int kept = 0, G = 0, best_w = 0;
+    for (int g = 0; g < nb_groups; g++){
+        int first = kept;
+        for (int k = group_start[g]; k < group_start[g + 1]; k++){
+            if (items[k].w <= C && items[k].profit > 0){
+                items[kept++] = items[k];
+                if (items[kept - 1].profit > items[first].profit)
+                    swap(items[first], items[kept - 1]);
+            }
+        }
+        if (kept > first){
+            group_start[G++] = first;
+            best_w += items[first].w;
+        }
+    }
+    items.resize(kept);
+    group_start.resize(G);
+    group_start.push_back(kept);
+
+    // Le meilleur item de chaque groupe tient : pas de DP
+    double value = 0;
+    if (best_w <= C){
+        for (int g = 0; g < G; g++){
+            selection.push_back(items[group_start[g]]);
+            value += items[group_start[g]].profit;
+        }
+        return value;
+    }
+
+    size_t width = (size_t) C + 1;
+    dp.resize((G + 1) * width);
+    fill(dp.begin(), dp.begin() + width, 0.0);
+    for (int g = 0; g < G; g++){
+        const double* prev = &dp[g * width];
+        double* cur = &dp[(g + 1) * width];
+        memcpy(cur, prev, width * sizeof(double));
+        for (int k = group_start[g]; k < group_start[g + 1]; k++){
+            if (vectorized)
+                relax_vectorized(cur, prev, C, items[k].w, items[k].profit);
+            else
+                relax_scalar(cur, prev, C, items[k].w, items[k].profit);
+        }
+    }
+
+    // Remontée : à la couche g, la valeur vient soit de la couche précédente
+    // (aucun item), soit exactement de prev[c - w] + profit d'un item
+    value = dp[G * width + C];
+    int c = C;
+    for (int g = G - 1; g >= 0; g--){
+        const double* prev = &dp[g * width];
+        double v = dp[(g + 1) * width + c];
+        if (v == prev[c]){
+            continue;
+        }
+        for (int k = group_start[g]; k < group_start[g + 1]; k++){
+            if (items[k].w <= c && prev[c - items[k].w] + items[k].profit == v){
+                selection.push_back(items[k]);
+                c -= items[k].w;
+                break;
+            }
+        }
+    }
+    return value;
+}
@@ -0,0 +1,59 @@
+/*
+ Sac à dos d'un écran : noyau de programmation dynamique.
+
+ Sous la contrainte de durée, un écran est un sac à dos de capacité T_i
+ (secondes entières) dont les items sont les marques, de poids t_j, groupées
+ par type : au plus une marque de chaque groupe (marques concurrentes).
+ C'est l'oracle des relaxations et des décompositions (relaxation
+ lagrangienne, génération de colonnes) et des heuristiques.
+
+ dp_g[c] est le meilleur profit avec les g premiers groupes et au plus c
+ secondes : dp_g[c] = max(dp_{g-1}[c], max_k dp_{g-1}[c - w_k] + p_k). Pour
+ un item, la relaxation porte sur toutes les capacités c >= w_k à la fois et
+ se vectorise (AVX-512 ou AVX2 selon les options de compilation, par exemple
+ -march=native, sinon boucle scalaire). Les couches dp_g sont gardées :
+ les items choisis se retrouvent en remontant les couches, sans table de
+ choix, car max renvoie exactement l'une de ses opérandes.
+ */
+
+#ifndef KNAPSACK_H
+#define KNAPSACK_H
+
+#include <vector>
+
+// Jeu d'instructions utilisé par le noyau vectorisé
+const char* knapsack_isa();
+
+class Break_Knapsack {
+public:
+    struct Item {
+        int id;             // identifiant libre (la marque j)
+        int w;              // poids en secondes entières
+        double profit;
+    };
+
+    // vectorized = false : boucle scalaire (comparaison, tests)
+    explicit Break_Knapsack(bool vectorized = true) : vectorized(vectorized) {}
+
+    // Vide les items ; begin_group ouvre un nouveau groupe, add_item y ajoute
+    // un item. Les items de poids > capacité ou de profit <= 0 sont ignorés
+    // par solve, les groupes vides aussi.
+    void clear();
+    void begin_group();
+    void add_item(int id, int w, double profit);
+
+    // Résout avec la capacité C et renvoie le meilleur profit ; chosen()
+    // donne les items retenus. Les items sont réordonnés : clear() avant de
+    // remplir le sac à dos suivant.
+    double solve(int C);
+    const std::vector<Item>& chosen() const { return selection; }
+
+private:
+    bool vectorized;
+    std::vector<Item> items;
+    std::vector<int> group_start;   // items du groupe g : [group_start[g], group_start[g+1][
+    std::vector<double> dp;         // couches dp_0 .. dp_G, chacune de C + 1 valeurs
+    std::vector<Item> selection;
+};
+
+#endif
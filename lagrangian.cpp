@@ -0,0 +1,180 @@
+/*
+ Relaxation lagrangienne des budgets : sacs à dos par écran et sous-gradient.
+ */
+
+#include "lagrangian.h"
+#include "knapsack.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+const double FIT_EPS = 1e-6;
+const int STALL_ITERATIONS = 20;    // itérations sans progrès avant de diviser le pas
+const double MIN_THETA = 1e-4;
+const double DEFLECTION = 1.5;      // gamma de Camerini-Fratta-Maffioli
+
+// Solution des sacs à dos d'un bloc d'écrans
+struct Block_Result {
+    double value = 0;               // somme des profits réduits
+    double revenue = 0;             // revenu TV des marques choisies
+    vector<double> spend;           // dépense de chaque marque
+};
+
+// Sac à dos de l'écran i avec les profits réduits ; les paires dont le
+// prix dépasse le budget de la marque sont exclues
+void solve_break(const Instance& inst, Break_Knapsack& knapsack, int i, const vector<double>& lambda,
+                 double mu, bool by_grp, Block_Result& result)
+{
+    knapsack.clear();
+    for (int t = 0; t < inst.nb_Types(); t++){
+        knapsack.begin_group();
+        for (const int* it = inst.type_begin(t); it != inst.type_end(t); ++it){
+            int j = *it;
+            double price = inst.cost(i, j) * inst.brand_time[j];
+            if (price <= inst.budget_cap[j] + FIT_EPS){
+                knapsack.add_item(j, (int) floor(inst.brand_time[j] + FIT_EPS),
+                                  (by_grp ? inst.grp_of(i, j) : price) + (mu - lambda[j]) * price);
+            }
+        }
+    }
+    result.value += knapsack.solve((int) floor(inst.break_time[i] + FIT_EPS));
+    for (const auto& item : knapsack.chosen()){
+        double price = inst.cost(i, item.id) * inst.brand_time[item.id];
+        result.revenue += price;
+        result.spend[item.id] += price;
+    }
+}
+
+}
+
+
+Lagrangian_Bound lagrangian_bound(const Instance& inst, const Lagrangian_Options& opt)
+{
+    auto t0 = chrono::steady_clock::now();
+    int m = inst.nb_Com_Break, n = inst.nb_Brands;
+    int nb_threads = opt.threads > 0 ? opt.threads : max(1u, thread::hardware_concurrency());
+    nb_threads = max(1, min(nb_threads, m));
+    bool by_grp = opt.objective == Objective::GRP;
+    bool epsilon = opt.min_revenue > 0;
+
+    vector<Break_Knapsack> solvers(nb_threads);
+    vector<Block_Result> blocks(nb_threads);
+    Worker_Pool pool(nb_threads);     // gardé d'une itération à l'autre
+
+    // Départ : lambda_j = max_i v_ij / (c_ij * t_j), tous les profits réduits
+    // sont négatifs et L = sum_j lambda_j * BUDGET_j (pour le revenu TV, la
+    // somme des budgets)
+    vector<double> lambda(n, 0), direction(n, 0), g(n);
+    for (int i = 0; i < m; i++){
+        for (int j = 0; j < n; j++){
+            double price = inst.cost(i, j) * inst.brand_time[j];
+            if (price > 0){
+                lambda[j] = max(lambda[j], (by_grp ? inst.grp_of(i, j) : price) / price);
+            }
+        }
+    }
+    double mu = 0, direction_mu = 0;
+    double theta = 2;
+    int since_improvement = 0;
+
+    Lagrangian_Bound bound;
+    bound.upper_bound = HUGE_VAL;
+
+    for (bound.iterations = 0; bound.iterations < opt.max_iterations; bound.iterations++){
+        if (chrono::duration<double>(chrono::steady_clock::now() - t0).count() >= opt.time_limit){
+            break;
+        }
+
+        // Sacs à dos des écrans, un bloc contigu par thread
+        auto solve_block = [&](int t){
+            Block_Result& b = blocks[t];
+            b.value = 0;
+            b.revenue = 0;
+            b.spend.assign(n, 0);
+            int end = (int) ((long long) m * (t + 1) / nb_threads);
+            for (int i = (int) ((long long) m * t / nb_threads); i < end; i++){
+                solve_break(inst, solvers[t], i, lambda, mu, by_grp, b);
+            }
+        };
+        pool.run(nb_threads, solve_block);
+
+        double L = 0, revenue = 0;
+        vector<double>& spend = blocks[0].spend;
+        for (int t = 0; t < nb_threads; t++){
+            L += blocks[t].value;
+            revenue += blocks[t].revenue;
+            if (t > 0){
+                for (int j = 0; j < n; j++)
+                    spend[j] += blocks[t].spend[j];
+            }
+        }
+        for (int j = 0; j < n; j++){
+            L += lambda[j] * inst.budget_cap[j];
+        }
+        if (epsilon){
+            L -= mu * opt.min_revenue;
+        }
+
+        if (L < bound.upper_bound - FIT_EPS){
+            bound.upper_bound = L;
+            bound.lambda = lambda;
+            bound.mu = mu;
+            since_improvement = 0;
+        }
+        else if (++since_improvement >= STALL_ITERATIONS){
+            theta /= 2;
+            since_improvement = 0;
+        }
+        // borne atteinte par la solution connue : optimalité prouvée
+        if (bound.upper_bound - opt.lower_bound <= FIT_EPS * max(1.0, fabs(bound.upper_bound)) || theta < MIN_THETA){
+            bound.iterations++;
+            break;
+        }
+
+        // Sous-gradient projeté : une composante nulle qui deviendrait
+        // négative reste nulle
+        double g_mu = epsilon ? revenue - opt.min_revenue : 0;
+        if (mu <= 0 && g_mu > 0)
+            g_mu = 0;
+        double dot = g_mu * direction_mu, prev_norm = direction_mu * direction_mu;
+        for (int j = 0; j < n; j++){
+            g[j] = inst.budget_cap[j] - spend[j];
+            if (lambda[j] <= 0 && g[j] > 0)
+                g[j] = 0;
+            dot += g[j] * direction[j];
+            prev_norm += direction[j] * direction[j];
+        }
+
+        // Direction déviée si le sous-gradient fait un angle obtus avec la précédente
+        double beta = dot < 0 && prev_norm > 0 ? -DEFLECTION * dot / prev_norm : 0;
+        double norm = 0;
+        for (int j = 0; j < n; j++){
+            direction[j] = g[j] + beta * direction[j];
+            norm += direction[j] * direction[j];
+        }
+        direction_mu = g_mu + beta * direction_mu;
+        norm += direction_mu * direction_mu;
+        if (norm <= 0){
+            bound.iterations++;
+            break;                  // solution de la relaxation réalisable et complémentaire
+        }
+
+        double step = theta * max(L - opt.lower_bound, FIT_EPS * max(1.0, fabs(L))) / norm;
+        for (int j = 0; j < n; j++){
+            lambda[j] = max(0.0, lambda[j] - step * direction[j]);
+        }
+        mu = max(0.0, mu - step * direction_mu);
+    }
+
+    bound.time = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    return bound;
+}
@@ -0,0 +1,48 @@
+/*
+ Relaxation lagrangienne des contraintes de budget : bornes supérieures du
+ revenu TV et du GRP sur les instances trop grandes pour le modèle exact.
+
+ Les contraintes sum_i c_ij * t_j * x_ij <= BUDGET_j sont dualisées avec des
+ multiplicateurs lambda_j >= 0 (et, avec une epsilon-contrainte, revenu TV
+ >= E avec mu >= 0). Le problème se décompose alors en un sac à dos par
+ écran : capacité T_i, poids t_j, au plus une marque de chaque type, profit
+ réduit v_ij + (mu - lambda_j) * c_ij * t_j. Les sacs à dos sont résolus
+ exactement par le noyau de knapsack.h (durées arrondies à l'entier
+ inférieur, ce qui reste une relaxation si elles ne sont pas entières), en
+ parallèle par blocs d'écrans sur un groupe de threads créé une fois pour
+ tout le calcul (worker_pool.h).
+
+ Les multiplicateurs sont mis à jour par sous-gradient avec pas de Polyak
+ vers la meilleure solution connue (lower_bound) et direction déviée
+ (Camerini-Fratta-Maffioli) ; le pas est divisé par deux quand la borne ne
+ progresse plus. Toute valeur L(lambda, mu) est une borne supérieure : la
+ meilleure est renvoyée.
+ */
+
+#ifndef LAGRANGIAN_H
+#define LAGRANGIAN_H
+
+#include <vector>
+#include "heuristic.h"
+#include "instance.h"
+
+struct Lagrangian_Options {
+    Objective objective = Objective::GRP;
+    double min_revenue = 0;     // epsilon-contrainte (0 = aucune)
+    double lower_bound = 0;     // valeur d'une solution réalisable (cible du pas)
+    int max_iterations = 500;
+    double time_limit = 60;     // secondes (temps réel)
+    int threads = 1;            // 0 = nombre de coeurs
+};
+
+struct Lagrangian_Bound {
+    double upper_bound = 0;         // meilleure borne L(lambda, mu)
+    std::vector<double> lambda;     // multiplicateurs de cette borne
+    double mu = 0;
+    int iterations = 0;
+    double time = 0;                // secondes
+};
+
+Lagrangian_Bound lagrangian_bound(const Instance& inst, const Lagrangian_Options& opt);
+
+#endif
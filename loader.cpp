@@ -0,0 +1,404 @@
+/*
+ Chargement des données : lecteur SAX des écrans en une passe, lecteur DOM de
+ référence et lecture des marques.
+ */
+
+#include "loader.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "json.hpp"
+
+using json = nlohmann::json;
+using namespace std;
+
+
+int64_t parse_date(const string& date)
+{
+    int y = 0, mo = 0, d = 0, h = 0, mi = 0, s = 0;
+    if (sscanf(date.c_str(), "%d-%d-%d %d:%d:%d", &y, &mo, &d, &h, &mi, &s) < 3){
+        throw runtime_error("Date invalide : " + date);
+    }
+
+    // Nombre de jours depuis le 1970-01-01 (calendrier grégorien proleptique)
+    y -= mo <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (mo + (mo > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    int64_t days = era * 146097 + doe - 719468;
+
+    return days * 86400 + h * 3600 + mi * 60 + s;
+}
+
+
+namespace {
+
+// "normal_3" -> 2, -1 si le nom ne correspond pas à une position connue
+int slot_index(const string& name)
+{
+    if (name.size() != 8 || name.compare(0, 7, "normal_") != 0){
+        return -1;
+    }
+    int s = name[7] - '1';
+    return (s >= 0 && s < NB_SLOTS) ? s : -1;
+}
+
+
+// Automate SAX : la profondeur dans le document indique ce que l'on lit
+//   1 : objet racine, clé = numéro d'écran
+//   2 : un écran (remaining_time, prime, grp, slots, ...)
+//   3 : grp (clé = audience) ou slots (clé = position)
+//   4 : une position (price, available)
+class Break_Sax : public nlohmann::json_sax<json> {
+public:
+    explicit Break_Sax(Instance& inst) : inst(inst) {}
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+    bool binary(binary_t&) override { return true; }
+
+    bool number_integer(number_integer_t val) override { return number((double) val); }
+    bool number_unsigned(number_unsigned_t val) override { return number((double) val); }
+    bool number_float(number_float_t val, const string_t&) override { return number(val); }
+
+    bool string(string_t& val) override
+    {
+        // "prime" et "available" sont fournis sous forme de chaîne ("0"/"1")
+        if (depth == 2 && field == PRIME){
+            inst.prime_break[cur] = stoi(val);
+        }
+        else if (depth == 2 && field == START_DATE){
+            inst.start_date[cur] = parse_date(val);
+        }
+        else if (depth == 2 && field == STATION){
+            // rejetée comme par le chargement DOM : station numérique seulement
+            throw runtime_error("Ecran " + to_string(cur) + " : station_name \"" + val + "\" n'est pas un nombre");
+        }
+        else if (depth == 4 && section == SLOTS && slot >= 0 && slot_field == AVAILABLE){
+            inst.slot_available[slot][cur] = (uint8_t) stoi(val);
+        }
+        return true;
+    }
+
+    bool start_object(size_t) override
+    {
+        depth++;
+        if (depth == 2){
+            field = NONE;
+        }
+        if (depth == 3){
+            section = field;
+        }
+        return true;
+    }
+
+    bool end_object() override
+    {
+        if (depth == 3){
+            section = NONE;
+        }
+        depth--;
+        return true;
+    }
+
+    bool start_array(size_t) override
+    {
+        depth++;
+        return true;
+    }
+
+    bool end_array() override
+    {
+        depth--;
+        return true;
+    }
+
+    bool key(string_t& val) override
+    {
+        switch (depth){
+            case 1:
+                cur = stoi(val);
+                inst.reserve_break(cur);
+                break;
+            case 2:
+                field = val == "remaining_time" ? REMAINING_TIME
+                      : val == "prime"          ? PRIME
+                      : val == "station_name"   ? STATION
+                      : val == "start_date"     ? START_DATE
+                      : val == "delay"          ? DELAY
+                      : val == "grp"            ? GRP
+                      : val == "slots"          ? SLOTS
+                      : NONE;
+                break;
+            case 3:
+                if (section == GRP){
+                    audience = inst.audience_id(val);
+                }
+                else if (section == SLOTS){
+                    slot = slot_index(val);
+                }
+                break;
+            case 4:
+                slot_field = val == "price"     ? PRICE
+                           : val == "available" ? AVAILABLE
+                           : NONE;
+                break;
+        }
+        return true;
+    }
+
+    bool parse_error(size_t position, const std::string&, const nlohmann::detail::exception& ex) override
+    {
+        throw runtime_error("Ecrans, position " + to_string(position) + " : " + ex.what());
+    }
+
+private:
+    enum Field { NONE, REMAINING_TIME, PRIME, STATION, START_DATE, DELAY, GRP, SLOTS, PRICE, AVAILABLE };
+
+    bool number(double val)
+    {
+        if (depth == 2){
+            switch (field){
+                case REMAINING_TIME: inst.break_time[cur] = (float) val; break;
+                case PRIME:          inst.prime_break[cur] = (int) val; break;
+                case STATION:        inst.station[cur] = (int) val; break;
+                case DELAY:          inst.delay[cur] = (int) val; break;
+                default: break;
+            }
+        }
+        else if (depth == 3 && section == GRP && audience >= 0){
+            inst.grp[audience][cur] = (float) val;
+        }
+        else if (depth == 4 && section == SLOTS && slot >= 0){
+            if (slot_field == PRICE){
+                inst.slot_price[slot][cur] = (int) val;
+            }
+            else if (slot_field == AVAILABLE){
+                inst.slot_available[slot][cur] = (uint8_t) val;
+            }
+        }
+        return true;
+    }
+
+    Instance& inst;
+    int depth = 0;
+    int cur = -1;            // écran courant
+    Field field = NONE;      // clé courante d'un écran
+    Field section = NONE;    // objet de profondeur 3 en cours (GRP ou SLOTS)
+    Field slot_field = NONE; // clé courante d'une position
+    int audience = -1;
+    int slot = -1;
+};
+
+ifstream open_input(const string& path)
+{
+    ifstream in(path, ios::binary);
+    if (!in){
+        throw runtime_error("Impossible d'ouvrir " + path);
+    }
+    return in;
+}
+
+json::input_format_t nlohmann_format(Input_Format format)
+{
+    switch (format){
+        case Input_Format::CBOR:    return json::input_format_t::cbor;
+        case Input_Format::MSGPACK: return json::input_format_t::msgpack;
+        case Input_Format::BSON:    return json::input_format_t::bson;
+        default:                    return json::input_format_t::json;
+    }
+}
+
+// Lecture complète d'un document, quel que soit son format
+json parse_document(istream& in, Input_Format format)
+{
+    switch (format){
+        case Input_Format::CBOR:    return json::from_cbor(in);
+        case Input_Format::MSGPACK: return json::from_msgpack(in);
+        case Input_Format::BSON:    return json::from_bson(in);
+        default:                    return json::parse(in);
+    }
+}
+
+bool has_extension(const string& path, const char* ext)
+{
+    size_t len = strlen(ext);
+    if (path.size() < len){
+        return false;
+    }
+    for (size_t k = 0; k < len; k++){
+        if (tolower((unsigned char) path[path.size() - len + k]) != ext[k]){
+            return false;
+        }
+    }
+    return true;
+}
+
+// "1" ou 1 -> 1
+int flag(const json& value)
+{
+    return value.is_string() ? stoi(value.get<string>()) : value.get<int>();
+}
+
+}
+
+
+const char* format_name(Input_Format format)
+{
+    switch (format){
+        case Input_Format::CBOR:    return "CBOR";
+        case Input_Format::MSGPACK: return "MessagePack";
+        case Input_Format::BSON:    return "BSON";
+        default:                    return "JSON";
+    }
+}
+
+
+Input_Format detect_format(const string& path)
+{
+    if (has_extension(path, ".json")){
+        return Input_Format::JSON;
+    }
+    if (has_extension(path, ".cbor")){
+        return Input_Format::CBOR;
+    }
+    if (has_extension(path, ".msgpack") || has_extension(path, ".mpk")){
+        return Input_Format::MSGPACK;
+    }
+    if (has_extension(path, ".bson")){
+        return Input_Format::BSON;
+    }
+
+    ifstream in = open_input(path);
+    unsigned char head[4] = {};
+    in.read((char*) head, sizeof(head));
+    size_t len = (size_t) in.gcount();
+    in.seekg(0, ios::end);
+    uint64_t size = (uint64_t) in.tellg();
+
+    if (len == 4){
+        uint32_t bson_size = head[0] | (head[1] << 8) | (head[2] << 16) | ((uint32_t) head[3] << 24);
+        if (bson_size == size){
+            return Input_Format::BSON;
+        }
+    }
+    if (len >= 3 && head[0] == 0xd9 && head[1] == 0xd9 && head[2] == 0xf7){
+        return Input_Format::CBOR;
+    }
+    if (len >= 1 && head[0] >= 0xa0 && head[0] <= 0xbf){
+        return Input_Format::CBOR;
+    }
+    if (len >= 1 && ((head[0] >= 0x80 && head[0] <= 0x8f) || head[0] == 0xde || head[0] == 0xdf)){
+        return Input_Format::MSGPACK;
+    }
+    return Input_Format::JSON;
+}
+
+
+void load_breaks_sax(istream& in, Instance& inst, Input_Format format)
+{
+    Break_Sax sax(inst);
+    json::sax_parse(in, &sax, nlohmann_format(format));
+}
+
+void load_breaks_sax(const string& path, Instance& inst)
+{
+    Input_Format format = detect_format(path);
+    ifstream in = open_input(path);
+    load_breaks_sax(in, inst, format);
+}
+
+
+void load_breaks_dom(istream& in, Instance& inst, Input_Format format)
+{
+    json breaks = parse_document(in, format);
+
+    for (const auto& item : breaks.items()){
+
+        int cpt = stoi(item.key());
+        inst.reserve_break(cpt);
+
+        // fill the break_time
+        inst.break_time[cpt] = item.value()["remaining_time"];
+
+        // fill the prime_break
+        inst.prime_break[cpt] = flag(item.value()["prime"]);
+
+        inst.station[cpt] = item.value()["station_name"];
+        inst.start_date[cpt] = parse_date(item.value()["start_date"]);
+        inst.delay[cpt] = item.value()["delay"];
+
+        // grp par audience
+        for (const auto& g : item.value()["grp"].items()){
+            inst.grp[inst.audience_id(g.key())][cpt] = g.value();
+        }
+
+        // prix et disponibilité des positions
+        for (const auto& s : item.value()["slots"].items()){
+            int k = slot_index(s.key());
+            if (k >= 0){
+                inst.slot_price[k][cpt] = s.value()["price"];
+                inst.slot_available[k][cpt] = (uint8_t) flag(s.value()["available"]);
+            }
+        }
+    }
+}
+
+void load_breaks_dom(const string& path, Instance& inst)
+{
+    Input_Format format = detect_format(path);
+    ifstream in = open_input(path);
+    load_breaks_dom(in, inst, format);
+}
+
+
+void load_brands(istream& in, Instance& inst, Input_Format format)
+{
+    json brands = parse_document(in, format);
+
+    for (const auto& brand : brands.items()){
+        int cpt = stoi(brand.key());
+        inst.reserve_brand(cpt);
+
+        // Brand_type
+        inst.brand_type[cpt] = inst.types.intern(brand.value()["type"]);
+        inst.brand_audience[cpt] = inst.audience_id(brand.value()["audience"]);
+        // GRP_j
+        inst.grp_cap[cpt] = brand.value()["cost_grp"];
+
+        // Brand time
+        inst.brand_time[cpt] = brand.value()["format"];
+
+        // BUDGET_j
+        inst.budget_cap[cpt] = brand.value()["budget"];
+
+        // PRIME_j
+        inst.prime[cpt] = brand.value()["ratio_prime"];
+        inst.premium[cpt] = brand.value().value("ratio_premium", 0.0f);
+
+        // PRIORITY_j
+        inst.priority[cpt] = brand.value().value("priority", 0.0f);
+    }
+}
+
+void load_brands(const string& path, Instance& inst)
+{
+    Input_Format format = detect_format(path);
+    ifstream in = open_input(path);
+    load_brands(in, inst, format);
+}
+
+
+Instance load_instance(const string& break_path, const string& brand_path)
+{
+    Instance inst;
+    load_breaks_sax(break_path, inst);
+    load_brands(brand_path, inst);
+    inst.build_grp_ij();
+    inst.build_type_groups();
+    return inst;
+}
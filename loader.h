@@ -0,0 +1,51 @@
+/*
+ Chargement des écrans publicitaires (break.json) et des marques (brands.json).
+
+ Les deux fichiers peuvent être en JSON texte ou dans l'un des formats binaires
+ lus par nlohmann::json (CBOR, MessagePack, BSON). Le format est déduit de
+ l'extension du fichier, ou à défaut de ses premiers octets.
+
+ Le fichier des écrans est lu en flux avec l'interface SAX de nlohmann::json :
+ aucun DOM n'est construit, les valeurs sont rangées directement dans les
+ colonnes de l'instance au fil de la lecture. La version DOM est conservée
+ comme référence pour le benchmark (bench.cpp).
+ Le fichier des marques, petit, est lu en DOM.
+ */
+
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <istream>
+#include <string>
+#include "instance.h"
+
+enum class Input_Format { JSON, CBOR, MSGPACK, BSON };
+
+const char* format_name(Input_Format format);
+
+// .json, .cbor, .msgpack/.mpk, .bson ; sinon examen des premiers octets :
+//   '{'                          -> JSON
+//   0xa0-0xbf ou tag 0xd9d9f7    -> CBOR (map)
+//   0x80-0x8f, 0xde, 0xdf        -> MessagePack (map)
+//   int32 = taille du fichier    -> BSON
+Input_Format detect_format(const std::string& path);
+
+// Lecture en une passe via json::sax_parse. Lève std::runtime_error si le
+// fichier est mal formé.
+void load_breaks_sax(std::istream& in, Instance& inst, Input_Format format = Input_Format::JSON);
+void load_breaks_sax(const std::string& path, Instance& inst);
+
+// Lecture de référence : json::parse du document entier puis parcours des items
+void load_breaks_dom(std::istream& in, Instance& inst, Input_Format format = Input_Format::JSON);
+void load_breaks_dom(const std::string& path, Instance& inst);
+
+void load_brands(std::istream& in, Instance& inst, Input_Format format = Input_Format::JSON);
+void load_brands(const std::string& path, Instance& inst);
+
+// Ecrans + marques + données dérivées (grp_ij, groupes de types)
+Instance load_instance(const std::string& break_path, const std::string& brand_path);
+
+// "2021-03-01 22:43:07" -> secondes depuis 1970 (UTC)
+int64_t parse_date(const std::string& date);
+
+#endif
@@ -0,0 +1,414 @@
+/*
+ Recherche locale et grands voisinages (LNS) sur une allocation x_ij.
+ */
+
+#include "local_search.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+const double FIT_EPS = 1e-6;        // tolérance sur les durées et les budgets
+const int CHECK_EVERY = 1024;       // itérations entre deux lectures de l'horloge
+const int MAX_BLOCK = 64;           // écrans vidés au plus par une étape LNS
+
+// Etat incrémental d'une allocation. Au plus une marque de chaque type par
+// écran : la case (i, t) suffit à décrire les spots, et x_ij vaut 1 si et
+// seulement si type_brand[i * T + type(j)] == j.
+class Search_State {
+public:
+    Search_State(const Instance& inst, const Allocation& start, Objective objective)
+        : inst(inst), m(inst.nb_Com_Break), n(inst.nb_Brands), T(inst.nb_Types()),
+          by_grp(objective == Objective::GRP),
+          remaining_time(m), remaining_budget(n),
+          type_brand((size_t) m * T, -1), slot_pos((size_t) m * T, -1)
+    {
+        for (int i = 0; i < m; i++){
+            remaining_time[i] = inst.break_time[i];
+        }
+        for (int j = 0; j < n; j++){
+            remaining_budget[j] = inst.budget_cap[j];
+        }
+        for (int i = 0; i < m; i++){
+            for (int j = 0; j < n; j++){
+                if (start.x[(size_t) i * n + j]){
+                    add(i, j);
+                }
+            }
+        }
+    }
+
+    const Instance& inst;
+    int m, n, T;
+    bool by_grp;
+
+    vector<double> remaining_time;
+    vector<double> remaining_budget;
+    vector<int> type_brand;         // marque du type t sur l'écran i, -1 sinon
+    vector<int> slot_pos;           // position de la case (i, t) dans slots
+    vector<int> slots;              // cases (i, t) occupées
+    double revenue = 0;
+    double grp = 0;
+
+    // même calcul que le coefficient du modèle
+    double price(int i, int j) const { return inst.cost(i, j) * inst.brand_time[j]; }
+    double value(int i, int j) const { return by_grp ? inst.grp_of(i, j) : price(i, j); }
+    double objective() const { return by_grp ? grp : revenue; }
+
+    int slot(int i, int j) const { return i * T + inst.brand_type[j]; }
+    bool has(int i, int j) const { return type_brand[slot(i, j)] == j; }
+    int brand_of_slot(int s) const { return type_brand[s]; }
+
+    void add(int i, int j)
+    {
+        int s = slot(i, j);
+        type_brand[s] = j;
+        slot_pos[s] = (int) slots.size();
+        slots.push_back(s);
+        remaining_time[i] -= inst.brand_time[j];
+        remaining_budget[j] -= price(i, j);
+        revenue += price(i, j);
+        grp += inst.grp_of(i, j);
+    }
+
+    void remove(int i, int j)
+    {
+        int s = slot(i, j);
+        int last = slots.back();
+        slots[slot_pos[s]] = last;
+        slot_pos[last] = slot_pos[s];
+        slots.pop_back();
+        slot_pos[s] = -1;
+        type_brand[s] = -1;
+        remaining_time[i] += inst.brand_time[j];
+        remaining_budget[j] += price(i, j);
+        revenue -= price(i, j);
+        grp -= inst.grp_of(i, j);
+    }
+
+    Allocation allocation() const
+    {
+        Allocation alloc;
+        alloc.x.assign((size_t) m * n, 0);
+        for (int s : slots){
+            int i = s / T, j = type_brand[s];
+            alloc.x[(size_t) i * n + j] = 1;
+            alloc.revenue += price(i, j);
+            alloc.grp += inst.grp_of(i, j);
+            alloc.nb_spots++;
+        }
+        return alloc;
+    }
+};
+
+
+class Search_Worker {
+public:
+    Search_Worker(const Instance& inst, const Allocation& start, const Search_Options& opt, uint64_t seed)
+        : st(inst, start, opt.objective), opt(opt), rng(seed) {}
+
+    Search_State st;
+
+    void run(chrono::steady_clock::time_point deadline);
+
+private:
+    const Search_Options& opt;
+    mt19937_64 rng;
+    long stall = 0;
+
+    struct Change { int i, j; bool added; };
+    vector<Change> journal;
+
+    int random(int k) { return (int) (rng() % (uint64_t) k); }
+
+    bool feasible_revenue(double revenue) const { return revenue >= opt.min_revenue - FIT_EPS; }
+
+    // Critère d'acceptation ; met à jour le compteur de stagnation
+    bool accept(double d_obj, double d_rev)
+    {
+        bool ok;
+        bool improved;
+        if (feasible_revenue(st.revenue)){
+            ok = feasible_revenue(st.revenue + d_rev) && d_obj >= -FIT_EPS;
+            improved = d_obj > FIT_EPS;
+        }
+        else {
+            ok = improved = d_rev > FIT_EPS;
+        }
+        if (improved){
+            stall = 0;
+        }
+        return ok;
+    }
+
+    bool fits_time(int i, double t) const { return t <= st.remaining_time[i] + FIT_EPS; }
+    bool fits_budget(int j, double p) const { return p <= st.remaining_budget[j] + FIT_EPS; }
+
+    void try_add();
+    void try_move();
+    void try_replace();
+    void try_exchange();
+    void try_ejection();
+    void large_neighbourhood();
+};
+
+
+void Search_Worker::try_add()
+{
+    int i = random(st.m), j = random(st.n);
+    if (st.type_brand[st.slot(i, j)] >= 0 || !fits_time(i, st.inst.brand_time[j])
+        || !fits_budget(j, st.price(i, j))){
+        return;
+    }
+    if (accept(st.value(i, j), st.price(i, j))){
+        st.add(i, j);
+    }
+}
+
+
+// Le spot (i1, j) passe sur l'écran i2
+void Search_Worker::try_move()
+{
+    int s = st.slots[random((int) st.slots.size())];
+    int i1 = s / st.T, j = st.brand_of_slot(s);
+    int i2 = random(st.m);
+    if (i2 == i1 || st.type_brand[st.slot(i2, j)] >= 0 || !fits_time(i2, st.inst.brand_time[j])
+        || !fits_budget(j, st.price(i2, j) - st.price(i1, j))){
+        return;
+    }
+    if (accept(st.value(i2, j) - st.value(i1, j), st.price(i2, j) - st.price(i1, j))){
+        st.remove(i1, j);
+        st.add(i2, j);
+    }
+}
+
+
+// Sur l'écran i, la marque j1 est remplacée par j2
+void Search_Worker::try_replace()
+{
+    int s = st.slots[random((int) st.slots.size())];
+    int i = s / st.T, j1 = st.brand_of_slot(s);
+    int j2 = random(st.n);
+    if (j2 == j1){
+        return;
+    }
+    int other = st.type_brand[st.slot(i, j2)];
+    if ((other >= 0 && other != j1)
+        || !fits_time(i, st.inst.brand_time[j2] - st.inst.brand_time[j1]) || !fits_budget(j2, st.price(i, j2))){
+        return;
+    }
+    if (accept(st.value(i, j2) - st.value(i, j1), st.price(i, j2) - st.price(i, j1))){
+        st.remove(i, j1);
+        st.add(i, j2);
+    }
+}
+
+
+// Les spots (i1, j1) et (i2, j2) échangent leurs marques
+void Search_Worker::try_exchange()
+{
+    int s1 = st.slots[random((int) st.slots.size())];
+    int s2 = st.slots[random((int) st.slots.size())];
+    int i1 = s1 / st.T, j1 = st.brand_of_slot(s1);
+    int i2 = s2 / st.T, j2 = st.brand_of_slot(s2);
+    if (i1 == i2 || j1 == j2){
+        return;
+    }
+    int b1 = st.type_brand[st.slot(i1, j2)], b2 = st.type_brand[st.slot(i2, j1)];
+    double t1 = st.inst.brand_time[j1], t2 = st.inst.brand_time[j2];
+    if ((b1 >= 0 && b1 != j1) || (b2 >= 0 && b2 != j2)
+        || !fits_time(i1, t2 - t1) || !fits_time(i2, t1 - t2)
+        || !fits_budget(j1, st.price(i2, j1) - st.price(i1, j1))
+        || !fits_budget(j2, st.price(i1, j2) - st.price(i2, j2))){
+        return;
+    }
+    double d_obj = st.value(i1, j2) + st.value(i2, j1) - st.value(i1, j1) - st.value(i2, j2);
+    double d_rev = st.price(i1, j2) + st.price(i2, j1) - st.price(i1, j1) - st.price(i2, j2);
+    if (accept(d_obj, d_rev)){
+        st.remove(i1, j1);
+        st.remove(i2, j2);
+        st.add(i1, j2);
+        st.add(i2, j1);
+    }
+}
+
+
+// Ajout de (i, j) en évinçant la marque k de l'écran i, replacée si possible
+// sur un autre écran
+void Search_Worker::try_ejection()
+{
+    int i = random(st.m), j = random(st.n);
+    double tj = st.inst.brand_time[j];
+    int k = st.type_brand[st.slot(i, j)];
+    if (k == j){
+        return;
+    }
+    if (k < 0){
+        if (fits_time(i, tj)){
+            return;                 // simple ajout
+        }
+        // la durée manque : une marque de l'écran prise au hasard
+        int t0 = random(st.T);
+        for (int dt = 0; dt < st.T && k < 0; dt++){
+            k = st.type_brand[i * st.T + (t0 + dt) % st.T];
+        }
+        if (k < 0){
+            return;
+        }
+    }
+    if (!fits_time(i, tj - st.inst.brand_time[k]) || !fits_budget(j, st.price(i, j))){
+        return;
+    }
+
+    // replacement de k, budget de l'écran i rendu
+    int i2 = -1;
+    for (int attempt = 0; attempt < 3 && i2 < 0; attempt++){
+        int c = random(st.m);
+        if (c != i && st.type_brand[st.slot(c, k)] < 0 && fits_time(c, st.inst.brand_time[k])
+            && fits_budget(k, st.price(c, k) - st.price(i, k))){
+            i2 = c;
+        }
+    }
+
+    double d_obj = st.value(i, j) - st.value(i, k) + (i2 >= 0 ? st.value(i2, k) : 0);
+    double d_rev = st.price(i, j) - st.price(i, k) + (i2 >= 0 ? st.price(i2, k) : 0);
+    if (accept(d_obj, d_rev)){
+        st.remove(i, k);
+        st.add(i, j);
+        if (i2 >= 0){
+            st.add(i2, k);
+        }
+    }
+}
+
+
+// Vide un bloc d'écrans consécutifs puis le reconstruit glouton, par valeur
+// par seconde perturbée ; annulé si le résultat est moins bon
+void Search_Worker::large_neighbourhood()
+{
+    int len = min(st.m, 2 + random(MAX_BLOCK - 1));
+    int first = random(st.m - len + 1);
+    double before_obj = st.objective(), before_rev = st.revenue;
+    bool was_feasible = feasible_revenue(before_rev);
+    journal.clear();
+
+    for (int i = first; i < first + len; i++){
+        for (int t = 0; t < st.T; t++){
+            int k = st.type_brand[i * st.T + t];
+            if (k >= 0){
+                st.remove(i, k);
+                journal.push_back({ i, k, false });
+            }
+        }
+    }
+
+    // tant que le revenu est sous min_revenue, on reconstruit au revenu
+    bool by_revenue = !was_feasible || !st.by_grp;
+    uniform_real_distribution<double> noise(0.9, 1.1);
+    vector<pair<double, int>> candidates;
+    candidates.reserve((size_t) len * st.n);
+    for (int i = first; i < first + len; i++){
+        for (int j = 0; j < st.n; j++){
+            double t = max(1e-9, (double) st.inst.brand_time[j]);
+            double v = by_revenue ? st.price(i, j) : st.inst.grp_of(i, j);
+            candidates.push_back({ v / t * noise(rng), i * st.n + j });
+        }
+    }
+    sort(candidates.begin(), candidates.end(), greater<pair<double, int>>());
+    for (const auto& c : candidates){
+        int i = c.second / st.n, j = c.second % st.n;
+        if (st.type_brand[st.slot(i, j)] < 0 && fits_time(i, st.inst.brand_time[j])
+            && fits_budget(j, st.price(i, j))){
+            st.add(i, j);
+            journal.push_back({ i, j, true });
+        }
+    }
+
+    bool keep;
+    if (was_feasible){
+        keep = feasible_revenue(st.revenue) && st.objective() >= before_obj - FIT_EPS;
+    }
+    else {
+        keep = st.revenue >= before_rev - FIT_EPS;
+    }
+    if (!keep){
+        for (auto it = journal.rbegin(); it != journal.rend(); ++it){
+            if (it->added)
+                st.remove(it->i, it->j);
+            else
+                st.add(it->i, it->j);
+        }
+    }
+}
+
+
+void Search_Worker::run(chrono::steady_clock::time_point deadline)
+{
+    if (st.m == 0 || st.n == 0){
+        return;
+    }
+    // stagnation avant une étape LNS : de l'ordre de quelques passes sur les spots
+    long stall_limit = 20000 + 20L * st.m;
+
+    for (long it = 0; ; it++){
+        if (it % CHECK_EVERY == 0 && chrono::steady_clock::now() >= deadline){
+            break;
+        }
+        stall++;
+        int move = random(st.slots.empty() ? 1 : 5);
+        switch (move){
+            case 0: try_add(); break;
+            case 1: try_move(); break;
+            case 2: try_replace(); break;
+            case 3: try_exchange(); break;
+            default: try_ejection(); break;
+        }
+        if (stall > stall_limit){
+            large_neighbourhood();
+            stall = 0;
+        }
+    }
+}
+
+}
+
+
+Allocation local_search(const Instance& inst, const Allocation& start, const Search_Options& opt)
+{
+    int nb_threads = opt.threads > 0 ? opt.threads : max(1u, thread::hardware_concurrency());
+    auto deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(
+                                                        chrono::duration<double>(opt.time_limit));
+
+    vector<unique_ptr<Search_Worker>> workers;
+    for (int t = 0; t < nb_threads; t++){
+        workers.emplace_back(new Search_Worker(inst, start, opt, opt.seed + 0x9e3779b97f4a7c15ULL * (t + 1)));
+    }
+    vector<thread> threads;
+    for (auto& w : workers){
+        threads.emplace_back([&w, deadline](){ w->run(deadline); });
+    }
+    for (auto& t : threads){
+        t.join();
+    }
+
+    // revenu au-dessus de min_revenue d'abord, puis meilleur objectif
+    const Search_State* best = nullptr;
+    auto rank = [&](const Search_State& s){
+        return make_pair(s.revenue >= opt.min_revenue - FIT_EPS ? 1 : 0,
+                         s.revenue >= opt.min_revenue - FIT_EPS ? s.objective() : s.revenue);
+    };
+    for (auto& w : workers){
+        if (!best || rank(w->st) > rank(*best)){
+            best = &w->st;
+        }
+    }
+    return best->allocation();
+}
@@ -0,0 +1,44 @@
+/*
+ Recherche locale et grands voisinages (LNS) sur une allocation x_ij.
+
+ Voisinages, chacun évalué en O(1) grâce à l'état incrémental (durée restante
+ de chaque écran, budget restant de chaque marque, marque présente pour
+ chaque couple (écran, type), liste des spots placés) :
+    - ajout d'un spot (écran, marque),
+    - déplacement d'un spot de la marque j vers un autre écran,
+    - remplacement de la marque d'un spot par une autre sur le même écran,
+    - échange des marques de deux spots d'écrans différents,
+    - chaîne d'éjection : ajout d'un spot qui évince la marque du même type
+      (ou une autre marque de l'écran si la durée manque), la marque évincée
+      étant replacée sur un autre écran.
+ Un mouvement est accepté s'il n'aggrave pas l'objectif et garde le revenu
+ TV au-dessus de min_revenue (ou, si la solution de départ est en dessous,
+ s'il augmente le revenu). Quand la recherche stagne, un bloc d'écrans
+ consécutifs est vidé puis reconstruit glouton (LNS) ; la reconstruction est
+ annulée si elle est moins bonne.
+
+ Chaque thread part de la même allocation avec son propre générateur
+ aléatoire ; la meilleure allocation obtenue dans le temps imparti est
+ renvoyée.
+ */
+
+#ifndef LOCAL_SEARCH_H
+#define LOCAL_SEARCH_H
+
+#include <cstdint>
+#include "heuristic.h"
+#include "instance.h"
+
+struct Search_Options {
+    Objective objective = Objective::GRP;
+    double min_revenue = 0;     // epsilon-contrainte sur le revenu TV
+    double time_limit = 1;      // secondes (temps réel)
+    int threads = 1;            // 0 = nombre de coeurs
+    uint64_t seed = 1;
+};
+
+// start doit respecter les durées, les budgets et l'exclusion des marques
+// concurrentes (par exemple une allocation gloutonne)
+Allocation local_search(const Instance& inst, const Allocation& start, const Search_Options& opt);
+
+#endif
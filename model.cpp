@@ -0,0 +1,978 @@
+/*
+ Modèle du problème d'allocation et méthode d'epsilon-contrainte.
+ */
+
+#include "model.h"
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "pareto.h"
+#include "heuristic.h"
+#include "local_search.h"
+#include "lagrangian.h"
+#include "colgen.h"
+#include "decomposition.h"
+#include "rolling.h"
+
+using namespace std;
+
+
+// Les prix et les formats sont entiers, donc le revenu TV aussi :
+// "revenu > E2" s'écrit "revenu >= E2 + REVENUE_STEP"
+const double REVENUE_STEP = 1;
+
+// Poids total des termes d'augmentation (AUGMECON), chaque écart étant
+// divisé par l'étendue de son objectif : le terme reste < AUGMECON_DELTA,
+// bien en dessous de la résolution des GRP (0.001), et ne départage que des
+// solutions de même GRP
+const double AUGMECON_DELTA = 1e-6;
+
+
+Allocation_Model::Allocation_Model(const Instance& inst, const Options& opt, const Presolve& pre)
+    : inst(inst), backend(make_backend(opt)), pre(pre), nb_x(pre.nb_vars()), four_objectives(opt.objectives == 4)
+{
+    int j, k;
+    int nb_Com_Break = inst.nb_Com_Break;
+    int nb_Brands = inst.nb_Brands;
+
+    // VARIABLES : un x_ij (ou y_isj) par couple candidat du presolve,
+    // entier 0 .. taille de la classe sur la ligne d'une classe d'écrans
+    for (k = 0; k < nb_x; ){
+        int count = pre.row_count[pre.var_row[k]], end = k;
+        while (end < nb_x && pre.row_count[pre.var_row[end]] == count)
+            end++;
+        if (count == 1)
+            backend->add_variables(end - k);
+        else
+            backend->add_integer_variables(end - k, count);
+        k = end;
+    }
+
+    // Coefficients des deux objectifs
+    revenue.resize(nb_x);
+    grp.resize(nb_x);
+    for (k = 0; k < nb_x; k++){
+        revenue[k] = pre.var_spend[k];
+        grp[k] = inst.grp_of(pre.row_break[pre.var_row[k]], pre.var_brand[k]);
+    }
+
+    // Ne pas depasser le budget de chaque marque
+    vector<vector<int>> brand_vars(nb_Brands);
+    for (k = 0; k < nb_x; k++){
+        brand_vars[pre.var_brand[k]].push_back(k);
+    }
+    budget_rows.assign(nb_Brands, -1);
+    for (j = 0; j < nb_Brands; j++){
+        if (!pre.budget_row[j] || brand_vars[j].empty())
+            continue;
+        vector<double> Ctr0Coefs;
+        for (int v : brand_vars[j])
+            Ctr0Coefs.push_back(revenue[v]);
+        budget_rows[j] = backend->add_row(brand_vars[j], Ctr0Coefs, -SOLVER_INFINITY, inst.budget_cap[j]);
+    }
+
+    // Ne pas dépasser la limite de temps de chaque ecran
+    vector<int> Ctr1Vars;
+    vector<double> Ctr1Coefs;
+    for (int i = 0; i < nb_Com_Break; i++){
+        Ctr1Vars.clear();
+        Ctr1Coefs.clear();
+        for (k = pre.row_vars[pre.break_rows[i]]; k < pre.row_vars[pre.break_rows[i + 1]]; k++){
+            Ctr1Vars.push_back(k);
+            Ctr1Coefs.push_back(inst.brand_time[pre.var_brand[k]]);
+        }
+        if (pre.time_row[i] && !Ctr1Vars.empty())
+            backend->add_row(Ctr1Vars, Ctr1Coefs, -SOLVER_INFINITY, inst.break_time[i]);
+    }
+
+    // Ne pas avoir de marques compétitives sur le même écran (et avec les
+    // positions, une marque par position) : au plus un candidat par clique
+    for (int c = 0; c < pre.nb_cliques(); c++){
+        vector<int> Ctr2Vars(pre.clique_vars.begin() + pre.clique_start[c], pre.clique_vars.begin() + pre.clique_start[c + 1]);
+        backend->add_row(Ctr2Vars, vector<double>(Ctr2Vars.size(), 1), -SOLVER_INFINITY, pre.clique_rhs[c]);
+    }
+
+    // Candidats fixés par le presolve : sum x = somme de leurs bornes
+    vector<int> fixed_vars;
+    double fixed_sum = 0;
+    for (k = 0; k < nb_x; k++){
+        if (pre.fixed[k]){
+            fixed_vars.push_back(k);
+            fixed_sum += pre.row_count[pre.var_row[k]];
+        }
+    }
+    if (!fixed_vars.empty())
+        backend->add_row(fixed_vars, vector<double>(fixed_vars.size(), 1), fixed_sum, SOLVER_INFINITY);
+
+    // Epsilon-contrainte sur le revenu TV, inactive au départ
+    vector<int> all(revenue.size());
+    for (size_t v = 0; v < all.size(); v++){
+        all[v] = (int) v;
+    }
+    revenue_row = backend->add_row(all, revenue, -SOLVER_INFINITY, SOLVER_INFINITY);
+
+    if (four_objectives){
+        // Ecart au ratio prime de la marque j :
+        // sum_i c_ij * t_j * (fp(i) - PRIME_j / 100) * x_ij, |.| <= d_j
+        prime_gap.resize(revenue.size());
+        priority.resize(revenue.size());
+        for (k = 0; k < nb_x; k++){
+            j = pre.var_brand[k];
+            prime_gap[k] = revenue[k] * (inst.prime_break[pre.row_break[pre.var_row[k]]] - inst.prime[j] / 100.0);
+            priority[k] = inst.priority[j];
+        }
+        // |écart_j| <= dépense de j, bornée par le presolve
+        for (j = 0; j < nb_Brands; j++){
+            backend->add_continuous_variables(1, pre.max_spend[j]);
+        }
+        for (j = 0; j < nb_Brands; j++){
+            vector<int> Ctr3Vars = brand_vars[j];
+            vector<double> Ctr3Coefs;
+            for (int v : brand_vars[j])
+                Ctr3Coefs.push_back(prime_gap[v]);
+            Ctr3Vars.push_back(nb_x + j);
+            Ctr3Coefs.push_back(1);
+            backend->add_row(Ctr3Vars, Ctr3Coefs, 0, SOLVER_INFINITY);         // d_j + écart_j >= 0
+            for (size_t v = 0; v + 1 < Ctr3Coefs.size(); v++){
+                Ctr3Coefs[v] = -Ctr3Coefs[v];
+            }
+            backend->add_row(Ctr3Vars, Ctr3Coefs, 0, SOLVER_INFINITY);         // d_j - écart_j >= 0
+        }
+
+        vector<int> d_vars(nb_Brands);
+        for (j = 0; j < nb_Brands; j++){
+            d_vars[j] = nb_x + j;
+        }
+        prime_row = backend->add_row(d_vars, vector<double>(nb_Brands, 1), -SOLVER_INFINITY, SOLVER_INFINITY);
+        priority_row = backend->add_row(all, priority, -SOLVER_INFINITY, SOLVER_INFINITY);
+    }
+
+    backend->set_objective(revenue);
+}
+
+
+void Allocation_Model::maximize_revenue()
+{
+    backend->set_objective(revenue);
+}
+
+
+void Allocation_Model::maximize_grp(double revenue_weight, double prime_weight, double priority_weight)
+{
+    if (revenue_weight == 0 && prime_weight == 0 && priority_weight == 0){
+        backend->set_objective(grp);
+        return;
+    }
+    vector<double> coefs(backend->nb_variables(), 0);
+    for (size_t k = 0; k < grp.size(); k++){
+        coefs[k] = grp[k] + revenue_weight * revenue[k];
+        if (four_objectives)
+            coefs[k] += priority_weight * priority[k];
+    }
+    if (four_objectives){
+        for (int j = 0; j < inst.nb_Brands; j++){
+            coefs[nb_x + j] = -prime_weight;
+        }
+    }
+    backend->set_objective(coefs);
+}
+
+
+void Allocation_Model::set_min_revenue(double E)
+{
+    backend->set_row_bounds(revenue_row, E, SOLVER_INFINITY);
+}
+
+
+void Allocation_Model::set_revenue_range(double lb, double ub)
+{
+    backend->set_row_bounds(revenue_row, lb, ub);
+}
+
+
+void Allocation_Model::minimize_prime_deviation()
+{
+    vector<double> coefs(backend->nb_variables(), 0);
+    for (int j = 0; j < inst.nb_Brands; j++){
+        coefs[nb_x + j] = -1;
+    }
+    backend->set_objective(coefs);
+}
+
+
+void Allocation_Model::maximize_priority()
+{
+    backend->set_objective(priority);
+}
+
+
+void Allocation_Model::set_max_prime_deviation(double E3)
+{
+    backend->set_row_bounds(prime_row, -SOLVER_INFINITY, E3);
+}
+
+
+void Allocation_Model::set_min_priority(double E4)
+{
+    backend->set_row_bounds(priority_row, E4, SOLVER_INFINITY);
+}
+
+
+void Allocation_Model::add_current_start(bool keep)
+{
+    add_start(solution, keep);
+}
+
+
+vector<double> Allocation_Model::to_model_values(const vector<double>& x) const
+{
+    // Candidats fixés à leur borne, puis chaque marque de l'écran i compte
+    // sur la ligne de sa classe, ou avec les positions, prend la moins chère
+    // de ses lignes candidates encore libres
+    int n = inst.nb_Brands;
+    vector<double> values(nb_x, 0);
+    vector<char> used(pre.nb_rows(), 0), placed(n);
+    for (int k = 0; k < nb_x; k++){
+        if (pre.fixed[k]){
+            values[k] = pre.row_count[pre.var_row[k]];
+            used[pre.var_row[k]] = pre.row_slot[pre.var_row[k]] >= 0;
+        }
+    }
+    vector<int> rows;
+    for (int i = 0; i < inst.nb_Com_Break; i++){
+        int rep = pre.break_rep[i], first = pre.break_rows[rep];
+        if (first < pre.break_rows[rep + 1] && pre.row_slot[first] < 0){
+            for (int j = 0; j < n; j++){
+                int k = x[(size_t) i * n + j] > 0.5 ? pre.var_index(first, j) : -1;
+                if (k >= 0 && !pre.fixed[k] && values[k] < pre.row_count[first])
+                    values[k] += 1;
+            }
+            continue;
+        }
+        rows.clear();
+        for (int r = pre.break_rows[i]; r < pre.break_rows[i + 1]; r++)
+            rows.push_back(r);
+        if (rows.size() > 1){
+            sort(rows.begin(), rows.end(), [&](int a, int b){
+                return inst.slot_cost(i, pre.row_slot[a]) < inst.slot_cost(i, pre.row_slot[b]);
+            });
+        }
+        fill(placed.begin(), placed.end(), 0);
+        for (int r : rows){
+            for (int k = pre.row_vars[r]; k < pre.row_vars[r + 1]; k++)
+                placed[pre.var_brand[k]] |= values[k] > 0.5;
+        }
+        for (int j = 0; j < n; j++){
+            if (x[(size_t) i * n + j] < 0.5 || placed[j])
+                continue;
+            for (int r : rows){
+                int k = pre.var_index(r, j);
+                if (k >= 0 && !used[r]){
+                    values[k] = 1;
+                    used[r] = pre.row_slot[r] >= 0;
+                    break;
+                }
+            }
+        }
+    }
+    return values;
+}
+
+
+void Allocation_Model::add_start(const vector<double>& values, bool keep)
+{
+    // les variables auxiliaires absentes valent 0 (réparées par le solveur)
+    vector<double> start = values;
+    start.resize(backend->nb_variables(), 0);
+    backend->add_start(start, keep);
+}
+
+
+void Allocation_Model::quiet()
+{
+    verbose = false;
+    backend->quiet();
+}
+
+
+bool Allocation_Model::solve()
+{
+    auto start = chrono::steady_clock::now();
+    last_status = backend->solve();
+    last_solve_time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    bool ok = last_status == Solve_Status::OPTIMAL || last_status == Solve_Status::FEASIBLE;
+    solution = ok ? backend->values() : vector<double>();
+
+    if (verbose){
+        cout << "Taille du modele (" << backend->name() << ") : " << backend->nb_rows() << " contraintes lineaires, "
+             << backend->nb_variables() << " variables" << endl;
+        cout << "Temps de resolution : " << last_solve_time << " s" << endl;
+        if (first_incumbent_time() >= 0)
+            cout << "Temps avant la premiere solution : " << first_incumbent_time() << " s" << endl;
+    }
+    return ok;
+}
+
+
+void Allocation_Model::print_solution()
+{
+    cout << "Solution status: " << status_name(last_status) << endl;
+    if (last_status == Solve_Status::UNBOUNDED)
+        cout << "F.O. non born�e." << endl;
+    else
+    {
+        if (last_status == Solve_Status::INFEASIBLE || solution.empty())
+            cout << "Non-realisable." << endl;
+        else
+        {
+            if (last_status == Solve_Status::OPTIMAL)
+                cout << "Solution Optimale." << endl;
+            else
+                cout << "Solution realisable." << endl;
+
+            cout << " Valeur de la F.O. : " << (float)(objective_value()) << endl;
+
+            // x_ij par écran (comptes des classes répartis) ; avec les
+            // positions, une valeur par position
+            vector<double> x = allocation_values();
+            for (int i = 0; i < inst.nb_Com_Break; i++)
+            {
+                cout << " Ecran publicitaire " << i << " : " << endl;
+                bool by_slot = pre.break_rows[i] < pre.break_rows[i + 1] && pre.row_slot[pre.break_rows[i]] >= 0;
+                for (int r = pre.break_rows[i]; by_slot && r < pre.break_rows[i + 1]; r++)
+                {
+                    cout << " \t Position normal_" << pre.row_slot[r] + 1 << " : " << endl;
+                    for (int j = 0; j < inst.nb_Brands; j++)
+                    {
+                        int k = pre.var_index(r, j);
+                        cout << " \t Brand num " << j << " : ";
+                        cout << (k >= 0 ? solution[k] : 0) << " " ;
+                        cout << endl;
+                    }
+                }
+                for (int j = 0; !by_slot && j < inst.nb_Brands; j++)
+                {
+                    cout << " \t Brand num " << j << " : ";
+                    cout << x[(size_t) i * inst.nb_Brands + j] << " " ;
+                    cout << endl;
+                }
+                cout << endl;
+            }
+        }
+    }
+}
+
+
+void Allocation_Model::export_model(const string& path)
+{
+    backend->export_model(path);
+}
+
+
+// Les x_ij sont les revenue.size() premières variables de la solution
+double Allocation_Model::revenue_value() const
+{
+    double v = 0;
+    for (size_t k = 0; k < solution.size() && k < revenue.size(); k++){
+        v += revenue[k] * solution[k];
+    }
+    return v;
+}
+
+
+double Allocation_Model::grp_value() const
+{
+    double v = 0;
+    for (size_t k = 0; k < solution.size() && k < grp.size(); k++){
+        v += grp[k] * solution[k];
+    }
+    return v;
+}
+
+
+// Calculé sur les x_ij (et non les d_j, qui peuvent dépasser l'écart)
+double Allocation_Model::prime_deviation_value() const
+{
+    if (solution.empty() || !four_objectives)
+        return 0;
+    vector<double> gap(inst.nb_Brands, 0);
+    for (int k = 0; k < nb_x; k++){
+        gap[pre.var_brand[k]] += prime_gap[k] * solution[k];
+    }
+    double total = 0;
+    for (double g : gap){
+        total += fabs(g);
+    }
+    return total;
+}
+
+
+double Allocation_Model::priority_value() const
+{
+    double v = 0;
+    for (size_t k = 0; k < solution.size() && k < priority.size(); k++){
+        v += priority[k] * solution[k];
+    }
+    return v;
+}
+
+
+vector<double> Allocation_Model::allocation_values() const
+{
+    return expand_allocation(inst, pre, solution);
+}
+
+
+vector<double> Allocation_Model::budget_duals()
+{
+    vector<double> res(inst.nb_Brands, 0);
+    if (backend->solve_relaxation() != Solve_Status::OPTIMAL)
+        return res;
+    vector<double> duals = backend->duals();
+    for (int j = 0; j < inst.nb_Brands; j++){
+        if (budget_rows[j] >= 0)
+            res[j] = max(0.0, duals[budget_rows[j]]);
+    }
+    return res;
+}
+
+
+Pareto_Point Allocation_Model::pareto_point() const
+{
+    Pareto_Point p;
+    p.objectives = { revenue_value(), grp_value(), -prime_deviation_value(), priority_value() };
+    p.x = pack_allocation(allocation_values(), (size_t) inst.nb_Com_Break * inst.nb_Brands);
+    return p;
+}
+
+
+// Exploration parallèle du front : les intervalles ]a_k, b_k] du revenu TV
+// sont distribués aux threads à la demande. Dans chaque intervalle, la boucle
+// d'epsilon habituelle maximise le GRP sous a < revenu <= b jusqu'à ce que la
+// contrainte devienne irréalisable. Un point optimal dans son intervalle peut
+// être dominé par un point d'un intervalle supérieur : l'archive le rejette.
+static void solve_front_parallel(const Instance& inst, const Options& opt, const Presolve& pre,
+                                 double E2_min, double max_E2,
+                                 const vector<vector<double>>& starts, Pareto_Archive& archive)
+{
+    int nb_intervals = opt.intervals > 0 ? opt.intervals : 4 * opt.parallel;
+    // Bornes entières (le revenu l'est) : l'intervalle k commence au pas
+    // qui suit la borne haute de l'intervalle k - 1, aucun revenu n'est sauté
+    vector<double> bounds(nb_intervals + 1);
+    for (int k = 0; k <= nb_intervals; k++){
+        bounds[k] = floor(E2_min + (max_E2 - E2_min) * k / nb_intervals + PARETO_EPS);
+    }
+    bounds[nb_intervals] = floor(max_E2 + PARETO_EPS);
+
+    cout << "Exploration parallele : " << nb_intervals << " intervalles, "
+         << opt.parallel << " resolutions simultanees" << endl;
+
+    atomic<int> next(0);
+    atomic<bool> failed(false);
+    mutex out_mutex;
+    exception_ptr error;
+
+    auto worker = [&](){
+        // Un solveur par thread (un IloEnv par thread pour CPLEX)
+        try {
+            Allocation_Model model(inst, opt, pre);
+            model.quiet();
+            model.maximize_grp(max_E2 > E2_min ? AUGMECON_DELTA / (max_E2 - E2_min) : 0);
+            for (const auto& start : starts){
+                model.add_start(start, true);
+            }
+
+            int k;
+            while (!failed && (k = next++) < nb_intervals){
+                double E = bounds[k];
+                int nb_points = 0;
+                while (E + REVENUE_STEP <= bounds[k + 1]){
+                    model.set_revenue_range(E + REVENUE_STEP, bounds[k + 1]);
+                    if (!model.solve()){
+                        if (model.status() != Solve_Status::INFEASIBLE){
+                            lock_guard<mutex> lock(out_mutex);
+                            cout << "Intervalle " << k << " : arret, statut " << status_name(model.status()) << endl;
+                        }
+                        break;
+                    }
+                    Pareto_Point p = model.pareto_point();
+                    archive.insert(p);
+                    nb_points++;
+                    // Saut jusqu'au revenu de la solution seulement si elle
+                    // est optimale (comme la boucle séquentielle)
+                    E = model.status() == Solve_Status::OPTIMAL ? floor(p.revenue() + PARETO_EPS) : E + REVENUE_STEP;
+
+                    if (opt.warm_start)
+                        model.add_current_start(false);
+                }
+                lock_guard<mutex> lock(out_mutex);
+                cout << "Intervalle " << k << " ]" << bounds[k] << ", " << bounds[k + 1] << "] : "
+                     << nb_points << " points" << endl;
+            }
+        }
+        catch (...) {
+            lock_guard<mutex> lock(out_mutex);
+            failed = true;
+            if (!error)
+                error = current_exception();
+        }
+    };
+
+    vector<thread> threads;
+    for (int t = 0; t < opt.parallel; t++){
+        threads.emplace_back(worker);
+    }
+    for (auto& t : threads){
+        t.join();
+    }
+    if (error){
+        rethrow_exception(error);
+    }
+}
+
+
+// Valeurs des quatre objectifs d'une solution
+struct Objective_Values {
+    double revenue;
+    double grp;
+    double prime_deviation;     // à minimiser
+    double priority;
+};
+
+static Objective_Values current_objectives(const Allocation_Model& model)
+{
+    return { model.revenue_value(), model.grp_value(), model.prime_deviation_value(), model.priority_value() };
+}
+
+// Affiche le front de l'archive (revenu TV, GRP, puis écart prime et
+// priorité avec 4 objectifs) et l'écrit dans out_dir/front.txt
+static void print_front(const Pareto_Archive& archive, const string& out_dir)
+{
+    bool four = archive.nb_objectives() == 4;
+    cout << endl << "############################" << endl;
+    cout << "Front de Pareto (revenu TV, GRP" << (four ? ", ecart prime, priorite)" : ")") << endl;
+    vector<Pareto_Point> front = archive.points();
+    for (size_t k = 0; k < front.size(); k++){
+        cout << k << " : " << front[k].revenue() << " " << front[k].grp();
+        if (four)
+            cout << " " << -front[k].objectives[2] << " " << front[k].objectives[3];
+        cout << endl;
+    }
+    if (!out_dir.empty())
+        archive.save(out_dir + "/front.txt");
+}
+
+
+// Epsilon-contrainte à 4 objectifs : maximise le GRP sous revenu TV >= E2,
+// écart prime <= E3 et priorité >= E4, les E parcourant opt.grid valeurs
+// entre les extrêmes de la table des gains (payoff : une solution
+// mono-objectif par objectif). Chaque dimension va de la valeur la plus
+// lâche à la plus serrée ; une cellule est sautée si une cellule plus
+// lâche dans les trois dimensions est irréalisable (elle l'est aussi) ou a
+// une solution qui respecte déjà ses bornes (même optimum). Les solutions
+// vont dans l'archive, qui écarte les points dominés.
+static void solve_front_grid(Allocation_Model& model, const Options& opt, const vector<Objective_Values>& payoff,
+                             Pareto_Archive& archive)
+{
+    double lo2 = payoff[0].revenue, hi2 = lo2, lo3 = payoff[0].prime_deviation, hi3 = lo3;
+    double lo4 = payoff[0].priority, hi4 = lo4;
+    for (const auto& p : payoff){
+        lo2 = min(lo2, p.revenue);
+        hi2 = max(hi2, p.revenue);
+        lo3 = min(lo3, p.prime_deviation);
+        hi3 = max(hi3, p.prime_deviation);
+        lo4 = min(lo4, p.priority);
+        hi4 = max(hi4, p.priority);
+    }
+
+    // opt.grid valeurs de la plus lâche à la plus serrée (une seule si
+    // l'objectif ne varie pas)
+    auto levels = [&](double loose, double tight){
+        if (fabs(tight - loose) <= PARETO_EPS * max(1.0, fabs(tight)))
+            return vector<double>{ loose };
+        vector<double> v(opt.grid);
+        for (int k = 0; k < opt.grid; k++)
+            v[k] = loose + (tight - loose) * k / (opt.grid - 1);
+        return v;
+    };
+    vector<double> E2 = levels(lo2, hi2), E3 = levels(hi3, lo3), E4 = levels(lo4, hi4);
+
+    struct Cell {
+        int a, b, c;
+        bool feasible;
+        Objective_Values v;
+    };
+    vector<Cell> solved;
+    int nb_solves = 0, nb_infeasible = 0, nb_redundant = 0;
+
+    cout << "Grille d'epsilon : " << E2.size() << " x " << E3.size() << " x " << E4.size() << " cellules" << endl;
+    auto weight = [](double lo, double hi){ return hi > lo ? AUGMECON_DELTA / (hi - lo) : 0; };
+    model.maximize_grp(weight(lo2, hi2), weight(lo3, hi3), weight(lo4, hi4));
+
+    for (int a = 0; a < (int) E2.size(); a++){
+        for (int b = 0; b < (int) E3.size(); b++){
+            for (int c = 0; c < (int) E4.size(); c++){
+                bool skip = false;
+                for (const Cell& d : solved){
+                    if (d.a > a || d.b > b || d.c > c)
+                        continue;
+                    if (!d.feasible){
+                        nb_infeasible++;
+                        skip = true;
+                        break;
+                    }
+                    if (d.v.revenue >= E2[a] - PARETO_EPS && d.v.prime_deviation <= E3[b] + PARETO_EPS
+                        && d.v.priority >= E4[c] - PARETO_EPS){
+                        nb_redundant++;
+                        skip = true;
+                        break;
+                    }
+                }
+                if (skip)
+                    continue;
+
+                model.set_min_revenue(E2[a]);
+                model.set_max_prime_deviation(E3[b]);
+                model.set_min_priority(E4[c]);
+                nb_solves++;
+                cout << "Cellule (" << a << ", " << b << ", " << c << ") : E2 = " << E2[a] << ", E3 = " << E3[b]
+                     << ", E4 = " << E4[c] << endl;
+                if (!model.solve()){
+                    if (model.status() == Solve_Status::INFEASIBLE)
+                        solved.push_back({ a, b, c, false, {} });
+                    cout << "-> " << status_name(model.status()) << endl;
+                    continue;
+                }
+                Objective_Values v = current_objectives(model);
+                cout << "-> revenu TV " << v.revenue << ", GRP " << v.grp << ", ecart prime "
+                     << v.prime_deviation << ", priorite " << v.priority << endl;
+                solved.push_back({ a, b, c, true, v });
+                archive.insert(model.pareto_point());
+                if (opt.warm_start)
+                    model.add_current_start(false);
+            }
+        }
+    }
+
+    cout << endl << "Resolutions : " << nb_solves << ", cellules irrealisables sautees : " << nb_infeasible
+         << ", cellules deja resolues : " << nb_redundant << endl;
+}
+
+
+void solve_instance(const Instance& inst, const Options& opt, const string& out_dir)
+{
+    // Solutions extrêmes des problèmes mono -> valeur d'arrêt des epsilon-contraintes
+    double max_E2;
+
+    // Valeurs epsilon
+    double E2;
+
+    cout << "Nombre de spots : " << inst.nb_Com_Break << endl;
+    cout << "NOmbre de marques : " << inst.nb_Brands << endl;
+
+    // Temps de résolution et temps avant la première solution de chaque itération
+    vector<double> solve_times, first_times;
+
+    // Points non dominés et solutions de départ des résolutions parallèles
+    Pareto_Archive archive(opt.objectives);
+    vector<vector<double>> starts;
+
+    // Allocations gloutonnes : réponse immédiate, puis solutions de départ
+    vector<Allocation> greedy;
+    for (Greedy_Rule rule : { Greedy_Rule::GRP_PER_SECOND, Greedy_Rule::REVENUE_PER_SECOND }){
+        auto t0 = chrono::steady_clock::now();
+        greedy.push_back(greedy_allocation(inst, rule));
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        cout << "Glouton " << rule_name(rule) << " : revenu TV " << greedy.back().revenue
+             << ", GRP " << greedy.back().grp << ", " << greedy.back().nb_spots << " spots, "
+             << ms << " ms" << endl;
+    }
+
+    // Recherche locale : GRP pour le glouton GRP/s, revenu pour le glouton revenu/s
+    if (opt.local_search > 0){
+        Search_Options search;
+        search.time_limit = opt.local_search;
+        search.threads = opt.threads;
+        search.objective = Objective::GRP;
+        greedy[0] = local_search(inst, greedy[0], search);
+        search.objective = Objective::REVENUE;
+        greedy[1] = local_search(inst, greedy[1], search);
+        for (int k = 0; k < 2; k++){
+            cout << "Recherche locale " << (k == 0 ? "GRP" : "revenu TV") << " : revenu TV "
+                 << greedy[k].revenue << ", GRP " << greedy[k].grp << ", " << greedy[k].nb_spots
+                 << " spots" << endl;
+        }
+    }
+
+    // Bornes lagrangiennes, le pas visant la meilleure allocation connue
+    if (opt.lagrangian_bounds){
+        Lagrangian_Options lagrangian;
+        lagrangian.time_limit = opt.time_limit;
+        lagrangian.threads = opt.threads;
+        for (Objective objective : { Objective::REVENUE, Objective::GRP }){
+            bool by_grp = objective == Objective::GRP;
+            lagrangian.objective = objective;
+            lagrangian.lower_bound = 0;
+            for (const auto& alloc : greedy)
+                lagrangian.lower_bound = max(lagrangian.lower_bound, by_grp ? alloc.grp : alloc.revenue);
+            Lagrangian_Bound bound = lagrangian_bound(inst, lagrangian);
+            cout << "Borne lagrangienne " << (by_grp ? "GRP" : "revenu TV") << " : " << bound.upper_bound
+                 << " (meilleure allocation " << lagrangian.lower_bound << ", ecart "
+                 << 100 * (bound.upper_bound - lagrangian.lower_bound) / max(1e-9, bound.upper_bound)
+                 << " %, " << bound.iterations << " iterations, " << bound.time << " s)" << endl;
+        }
+    }
+    if (opt.greedy_only)
+        return;
+
+    // Génération de colonnes : pas de modèle x_ij
+    if (opt.column_generation){
+        for (Objective objective : { Objective::REVENUE, Objective::GRP }){
+            Colgen_Result cg = column_generation(inst, opt, objective, greedy);
+            cout << "Generation de colonnes " << (objective == Objective::GRP ? "GRP" : "revenu TV") << " : "
+                 << cg.rounds << " iterations, " << cg.nb_columns << " colonnes"
+                 << (cg.converged ? "" : " (non convergee)") << ", relaxation " << cg.lp_value
+                 << ", borne " << cg.upper_bound << endl;
+            cout << "    solution entiere (" << status_name(cg.status) << ") : revenu TV " << cg.allocation.revenue
+                 << ", GRP " << cg.allocation.grp << ", " << cg.allocation.nb_spots << " spots, "
+                 << cg.time << " s" << endl;
+        }
+        return;
+    }
+
+    // Décomposition par station : un modèle par station
+    if (opt.decompose > 0){
+        for (Objective objective : { Objective::REVENUE, Objective::GRP }){
+            bool by_grp = objective == Objective::GRP;
+            Decomposition_Result dec = decompose_stations(inst, opt, objective, greedy[by_grp ? 0 : 1]);
+            cout << "Decomposition par station " << (by_grp ? "GRP" : "revenu TV") << " : "
+                 << dec.nb_stations << " stations, " << dec.rounds << " tours, " << dec.nb_exchanges
+                 << " echanges de budget, " << dec.nb_solves
+                 << " resolutions (" << dec.nb_optimal << " stations optimales)" << endl;
+            cout << "    revenu TV " << dec.allocation.revenue << ", GRP " << dec.allocation.grp << ", "
+                 << dec.allocation.nb_spots << " spots, " << dec.time << " s" << endl;
+        }
+        return;
+    }
+
+    // Horizon glissant : un modèle par fenêtre de dates
+    if (opt.window > 0){
+        for (Objective objective : { Objective::REVENUE, Objective::GRP }){
+            bool by_grp = objective == Objective::GRP;
+            Rolling_Result rh = rolling_horizon(inst, opt, objective, greedy[by_grp ? 0 : 1]);
+            for (size_t w = 0; w < rh.windows.size(); w++){
+                const Window_Stats& ws = rh.windows[w];
+                cout << "Fenetre " << w << " : " << ws.nb_breaks << " ecrans, " << ws.nb_frozen
+                     << " figes, " << status_name(ws.status) << endl;
+            }
+            cout << "Horizon glissant " << (by_grp ? "GRP" : "revenu TV") << " : " << rh.nb_windows
+                 << " fenetres (" << rh.nb_optimal << " optimales)" << endl;
+            cout << "    revenu TV " << rh.allocation.revenue << ", GRP " << rh.allocation.grp << ", "
+                 << rh.allocation.nb_spots << " spots, " << rh.time << " s" << endl;
+        }
+        return;
+    }
+
+    // Modèle de base, construit et extrait une seule fois sur les candidats
+    // du presolve
+    Presolve pre = presolve(inst, opt);
+    print_presolve_stats(pre.stats);
+    Allocation_Model model(inst, opt, pre);
+
+    // Réalisables sans epsilon-contrainte : gardées pour toutes les résolutions
+    if (opt.warm_start){
+        for (const auto& alloc : greedy){
+            model.add_start(model.to_model_values(to_values(alloc)), true);
+            if (opt.parallel > 0)
+                starts.push_back(model.to_model_values(to_values(alloc)));
+        }
+    }
+
+
+    /* #######################
+    I - Resolution mono-objectifs on note leur solution epsilon
+    ####################### */
+
+    // MONO-OBJECTIF TV
+
+    cout <<  "Mono-objectif TV" << endl;
+
+    model.maximize_revenue();
+    if (!out_dir.empty())
+        model.export_model(out_dir + "/modelTV.lp");
+
+    if (!model.solve()) {
+        cerr << "Echec ... Non Lineaire?" << endl;
+        throw(-1);
+    }
+    model.print_solution();
+
+    max_E2 = model.revenue_value();
+    archive.insert(model.pareto_point());
+
+    // Table des gains des 4 objectifs : une ligne par mono-objectif
+    vector<Objective_Values> payoff;
+    payoff.push_back(current_objectives(model));
+
+    // Réalisable pour toutes les epsilon-contraintes : gardée jusqu'au bout
+    if (opt.warm_start){
+        model.add_current_start(true);
+        if (opt.parallel > 0)
+            starts.push_back(model.current_values());
+    }
+
+    cout << endl;
+    cout << "###############################" << endl;
+    cout << endl;
+
+
+    // MONO-OBJECTIF GRP
+
+    cout <<  "Mono-objectif GRP" << endl;
+
+    // Avoir un revenu des chaines TV non nul -> sinon : solution inutile
+    model.set_min_revenue(REVENUE_STEP);
+    model.maximize_grp(AUGMECON_DELTA / max(1.0, max_E2));
+    if (!out_dir.empty())
+        model.export_model(out_dir + "/modelGRP.lp");
+
+    if (!model.solve()) {
+        cerr << "Echec ... Non Lineaire?" << endl;
+        throw(-1);
+    }
+    model.print_solution();
+
+    E2 = model.revenue_value();
+    cout << "E2 = " << E2 << endl;
+
+    archive.insert(model.pareto_point());
+    payoff.push_back(current_objectives(model));
+
+    if (opt.warm_start){
+        model.add_current_start(true);
+        if (opt.parallel > 0)
+            starts.push_back(model.current_values());
+    }
+
+    cout << endl;
+    cout << "###############################" << endl;
+    cout << endl;
+
+    if (opt.objectives == 4){
+        // MONO-OBJECTIF ECART PRIME (revenu non nul, sinon aucun spot : écart nul)
+        cout <<  "Mono-objectif ecart prime" << endl;
+        model.minimize_prime_deviation();
+        if (!model.solve()) {
+            cerr << "Echec ... Non Lineaire?" << endl;
+            throw(-1);
+        }
+        payoff.push_back(current_objectives(model));
+        archive.insert(model.pareto_point());
+        cout << "Ecart prime = " << payoff.back().prime_deviation << endl << endl;
+
+        // MONO-OBJECTIF PRIORITE (nulle partout sans priorité dans les
+        // marques : la grille n'a alors qu'une valeur de E4)
+        if (all_of(inst.priority.begin(), inst.priority.end(), [](float p){ return p == 0; })){
+            cout << "Attention : priorite nulle pour toutes les marques, dimension E4 ignoree" << endl << endl;
+        }
+        else {
+            cout <<  "Mono-objectif priorite" << endl;
+            model.maximize_priority();
+            if (!model.solve()) {
+                cerr << "Echec ... Non Lineaire?" << endl;
+                throw(-1);
+            }
+            payoff.push_back(current_objectives(model));
+            archive.insert(model.pareto_point());
+            cout << "Priorite = " << payoff.back().priority << endl << endl;
+        }
+
+        solve_front_grid(model, opt, payoff, archive);
+        print_front(archive, out_dir);
+        return;
+    }
+
+    /* #######################
+    II - Boucler sur le problème de base jusqu'à obtenir toutes les solutions en variant les E-contraintes
+    ####################### */
+
+    if (opt.parallel > 0){
+        solve_front_parallel(inst, opt, pre, E2, max_E2, starts, archive);
+
+        print_front(archive, out_dir);
+        cout << endl << "max E2 : " << max_E2 << endl;
+        return;
+    }
+
+    cout <<  "RESOLUTION NORMALE" << endl;
+
+    // AUGMECON2 : max GRP + delta * s / r sous revenu TV - s = e, avec
+    // r = max_E2 - E2 l'étendue du revenu sur le front
+    double step = opt.epsilon_step > 0 ? opt.epsilon_step : REVENUE_STEP;
+    model.maximize_grp(max_E2 > E2 ? AUGMECON_DELTA / (max_E2 - E2) : 0);
+    double e = E2 + step;
+    long nb_bypassed = 0;
+
+    while (e <= max_E2 + PARETO_EPS){
+
+        // Seule la borne de l'epsilon-contrainte change
+        model.set_min_revenue(e);
+
+        if (!out_dir.empty())
+            model.export_model(out_dir + "/model.lp");
+
+        // RESOLUTION : irréalisable = plus aucun point au-delà de e
+        if (!model.solve()) {
+            if (model.status() == Solve_Status::INFEASIBLE)
+                break;
+            cerr << "Echec ... Non Lineaire?" << endl;
+            throw(-1);
+        }
+        model.print_solution();
+
+        cout << "-> Valeur de la F.O (GRP) : " << (float) model.grp_value() << endl;
+
+        E2 = model.revenue_value();
+
+        // Saut : les valeurs e + step, ..., e + b * step (b = s / step)
+        // redonneraient la même solution, si elle est optimale ; une
+        // solution seulement réalisable (limite de temps) n'avance que d'un pas
+        long b = model.status() == Solve_Status::OPTIMAL ? (long) floor((E2 - e) / step + PARETO_EPS) : 0;
+        nb_bypassed += b;
+        e += (b + 1) * step;
+
+        archive.insert(model.pareto_point());
+        solve_times.push_back(model.solve_time());
+        first_times.push_back(model.first_incumbent_time());
+
+        // Point de Pareto voisin du suivant : réparé puis utilisé comme départ
+        if (opt.warm_start)
+            model.add_current_start(false);
+
+        cout << "E2 = " << E2 << endl;
+    }
+
+    print_front(archive, out_dir);
+
+    cout << endl << "max E2 : " << max_E2 << endl;
+    cout << "Resolutions : " << solve_times.size() << ", valeurs d'epsilon sautees : " << nb_bypassed << endl;
+
+    cout << endl << "Temps par iteration (" << (opt.warm_start ? "MIP starts" : "depart a froid") << ") :" << endl;
+    for (size_t k = 0; k < solve_times.size(); k++)
+    {
+        cout << k + 1 << " : resolution " << solve_times[k] << " s, premiere solution ";
+        if (first_times[k] >= 0)
+            cout << first_times[k] << " s" << endl;
+        else
+            cout << "non mesuree (hors branch-and-bound)" << endl;
+    }
+}
@@ -0,0 +1,174 @@
+/*
+ Modèle du problème d'allocation et méthode d'epsilon-contrainte.
+
+ Le modèle de base (variables x_ij, contraintes de budget, de durée des écrans
+ et de marques concurrentes) est construit une seule fois dans le solveur
+ choisi (voir solver.h). Avec opt.slots, les variables sont y_isj : marque j
+ dans la position s (normal_1 .. normal_5) de l'écran i, au prix de cette
+ position, et n'existent que pour les positions disponibles ; une position
+ reçoit au plus une marque et une marque au plus une position par écran.
+ Seuls les couples candidats et les contraintes non redondantes du presolve
+ (presolve.h) entrent dans le modèle. Les résolutions successives ne modifient que
+ l'objectif (revenu TV ou GRP) et les bornes de la contrainte d'epsilon sur
+ le revenu TV : le solveur conserve ses structures d'une résolution à
+ l'autre.
+
+ Les solutions déjà trouvées peuvent être données au solveur comme MIP
+ starts. La solution du mono-objectif TV reste réalisable pour toutes les
+ epsilon-contraintes ; celles du mono-objectif GRP et de l'itération
+ précédente violent la nouvelle borne sur le revenu et sont réparées par
+ CPLEX (MIPStartRepair) ; le solveur natif les ignore alors.
+ */
+
+#ifndef MODEL_H
+#define MODEL_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "instance.h"
+#include "options.h"
+#include "pareto.h"
+#include "presolve.h"
+#include "solver.h"
+
+class Allocation_Model {
+public:
+    Allocation_Model(const Instance& inst, const Options& opt, const Presolve& pre);
+
+    Allocation_Model(const Allocation_Model&) = delete;
+    Allocation_Model& operator=(const Allocation_Model&) = delete;
+
+    // Objectif : revenu TV sum c_ij * t_j * x_ij, ou GRP sum grp_ij * x_ij.
+    // Les poids ajoutent au GRP les termes d'augmentation d'AUGMECON :
+    // revenue_weight * revenu TV, - prime_weight * sum_j d_j et
+    // priority_weight * priorité (les écarts des epsilon-contraintes à une
+    // constante près).
+    void maximize_revenue();
+    void maximize_grp(double revenue_weight = 0, double prime_weight = 0, double priority_weight = 0);
+
+    // Contrainte d'epsilon : revenu TV >= E (-SOLVER_INFINITY pour la désactiver)
+    void set_min_revenue(double E);
+
+    // Epsilon-contrainte bornée des deux côtés : lb <= revenu TV <= ub
+    void set_revenue_range(double lb, double ub);
+
+    // Objectifs 3 et 4 (opt.objectives == 4 seulement) :
+    //    - écart au ratio prime : pour chaque marque, dépense sur les écrans
+    //      prime moins PRIME_j % de sa dépense totale, en valeur absolue
+    //      linéarisée par une variable d_j >= +-écart_j ; à minimiser ;
+    //    - priorité sum PRIORITY_j * x_ij, à maximiser.
+    void minimize_prime_deviation();
+    void maximize_priority();
+
+    // Epsilon-contraintes : sum_j d_j <= E3 et priorité >= E4
+    // (+-SOLVER_INFINITY pour les désactiver)
+    void set_max_prime_deviation(double E3);
+    void set_min_priority(double E4);
+
+    // Ajoute la solution courante comme MIP start. Une solution gardée (keep)
+    // sert pour toutes les résolutions suivantes ; sinon elle remplace le
+    // précédent start non gardé.
+    void add_current_start(bool keep);
+
+    // Idem avec des valeurs de variables du modèle, par exemple une solution
+    // trouvée par un autre modèle
+    void add_start(const std::vector<double>& values, bool keep);
+
+    // Variables du modèle d'une allocation x_ij à plat (x[i * nb_Brands + j]) :
+    // les candidats fixés valent 1, et chaque marque est placée sur la moins
+    // chère des lignes candidates encore libres de son écran (les couples
+    // éliminés et les marques en trop sont retirés)
+    std::vector<double> to_model_values(const std::vector<double>& x) const;
+
+    // Variables de la solution courante, à plat
+    std::vector<double> current_values() const { return solution; }
+
+    // x_ij par écran de la solution courante (x[i * nb_Brands + j]), les
+    // comptes des classes d'écrans agrégées répartis sur leurs écrans
+    std::vector<double> allocation_values() const;
+
+    // Plus aucune sortie du solveur (résolutions en parallèle)
+    void quiet();
+
+    // Lance le solveur, affiche la taille du modèle, le temps de résolution
+    // et le temps avant la première solution réalisable. Renvoie true si une
+    // solution réalisable a été trouvée.
+    bool solve();
+
+    // Affiche le statut, la valeur de l'objectif et les x_ij de la solution
+    void print_solution();
+
+    void export_model(const std::string& path);
+
+    // Valeurs de la solution courante
+    double revenue_value() const;
+    double grp_value() const;
+    double prime_deviation_value() const;
+    double priority_value() const;
+
+    // Prix dual du budget de chaque marque dans la relaxation linéaire de
+    // l'objectif courant (gain par unité de budget ; 0 si la contrainte est
+    // redondante ou si la relaxation échoue). La solution courante est gardée.
+    std::vector<double> budget_duals();
+
+    // Point de Pareto de la solution courante : revenu TV, GRP (puis
+    // - écart prime et priorité avec 4 objectifs) et bitmap des x_ij par écran
+    Pareto_Point pareto_point() const;
+    double objective_value() const { return backend->objective_value(); }
+    Solve_Status status() const { return last_status; }
+
+    // Temps de la dernière résolution et temps avant sa première solution
+    // réalisable (-1 si aucune)
+    double solve_time() const { return last_solve_time; }
+    double first_incumbent_time() const { return backend->first_incumbent_time(); }
+
+private:
+    const Instance& inst;
+    bool verbose = true;
+    std::unique_ptr<Solver_Backend> backend;
+
+    // Variables d'allocation : la variable k est le candidat k du presolve
+    // (marque pre.var_brand[k] sur la ligne pre.var_row[k])
+    Presolve pre;
+    int nb_x;                       // nombre de variables d'allocation
+
+    std::vector<double> revenue;    // coefficients du revenu TV
+    std::vector<double> grp;        // coefficients du GRP
+    std::vector<int> budget_rows;   // ligne du budget de chaque marque, -1 si redondant
+    int revenue_row;                // revenu TV >= E2
+
+    // 4 objectifs : d_j est la variable nb_x + j
+    bool four_objectives;
+    std::vector<double> prime_gap;  // écart_j = sum_(k de la marque j) prime_gap[k] * x_k
+    std::vector<double> priority;   // coefficients de la priorité
+    int prime_row = -1;             // sum_j d_j <= E3
+    int priority_row = -1;          // priorité >= E4
+
+    Solve_Status last_status = Solve_Status::UNKNOWN;
+    std::vector<double> solution;
+    double last_solve_time = 0;
+};
+
+// Résout l'instance : allocations gloutonnes (seules si opt.greedy_only,
+// sinon solutions de départ), mono-objectifs revenu TV et GRP, puis boucle
+// d'epsilon-contrainte augmentée (AUGMECON2) sur le revenu TV : le GRP est
+// augmenté d'un petit terme en revenu, ce qui écarte les points faiblement
+// dominés, et l'écart s = revenu - E2 de chaque solution fait sauter les
+// valeurs de E2 (pas opt.epsilon_step) qui redonneraient la même solution.
+// La boucle s'arrête quand l'epsilon-contrainte devient irréalisable.
+// Avec opt.objectives == 4, le GRP est maximisé sur une grille
+// d'epsilon-contraintes (revenu TV, écart prime, priorité) parcourue de la
+// plus lâche à la plus serrée : une cellule plus serrée qu'une cellule
+// irréalisable, ou dont une cellule plus lâche a déjà une solution qui la
+// respecte, n'est pas résolue. Avec opt.parallel > 0, l'intervalle
+// de revenu [E2_min, max_E2] est découpé en opt.intervals morceaux résolus
+// simultanément, chacun avec son propre solveur, et les points trouvés sont
+// filtrés dans une archive de Pareto commune. Avec opt.column_generation,
+// opt.decompose ou opt.window, seuls les mono-objectifs sont résolus
+// (colgen.h, decomposition.h, rolling.h). Les modèles sont exportés en .lp
+// dans out_dir s'il est non vide.
+// Lève std::runtime_error, ou -1 si une résolution échoue.
+void solve_instance(const Instance& inst, const Options& opt, const std::string& out_dir);
+
+#endif
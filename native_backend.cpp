@@ -0,0 +1,911 @@
+/*
+ Solveur natif : simplexe borné et branch-and-bound.
+ */
+
+#include "native_backend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+using namespace std;
+
+
+namespace {
+
+const double PIVOT_EPS = 1e-9;      // plus petit pivot accepté
+const double COST_EPS = 1e-9;       // coût réduit considéré comme positif
+const double FEAS_EPS = 1e-6;       // tolérance sur les lignes et l'intégralité
+const int DEGENERATE_STREAK = 50;   // pivots dégénérés avant la règle de Bland
+
+enum class Lp_Status { OPTIMAL, INFEASIBLE, UNBOUNDED };
+
+double row_tolerance(double bound)
+{
+    return FEAS_EPS * max(1.0, fabs(bound));
+}
+
+// Relaxation linéaire d'un noeud : max c.x sous les lignes du modèle, les
+// variables fixées (fix[j] = 0 ou 1) étant remplacées par leur valeur et les
+// autres dans [0, upper[j]] (1 pour une binaire). Si duals est donné, il
+// reçoit la valeur duale de chaque ligne du modèle.
+//
+// Tableau : x_B(i) + sum_j T[i][j] x_j = rhs[i] pour chaque ligne i, et
+// objectif z + sum_j d[j] x_j sur les variables hors base. Une variable hors
+// base est toujours nulle : une variable à sa borne supérieure u est
+// remplacée par son complément u - x (comp[j]).
+class Lp_Relaxation {
+public:
+    Lp_Status solve(const vector<Native_Backend::Row>& model_rows, const vector<double>& objective,
+                    const vector<double>& var_upper, const vector<signed char>& fix,
+                    vector<double>& x, double& value, vector<double>* duals = nullptr);
+
+private:
+    int nb_rows = 0;
+    int nb_cols = 0;
+    int first_artificial = 0;
+    vector<double> T;
+    vector<double> rhs;
+    vector<double> upper;
+    vector<double> d;
+    vector<int> basis;
+    vector<int> pos;            // ligne où la colonne est en base, -1 sinon
+    vector<char> comp;
+    double z = 0;
+
+    double& at(int i, int j) { return T[(size_t) i * nb_cols + j]; }
+
+    void pivot(int r, int j);
+    void complement(int j);
+    void complement_basic(int r);
+    bool run();
+};
+
+
+void Lp_Relaxation::pivot(int r, int j)
+{
+    double* row_r = &T[(size_t) r * nb_cols];
+    double piv = row_r[j];
+    for (int k = 0; k < nb_cols; k++){
+        row_r[k] /= piv;
+    }
+    rhs[r] /= piv;
+
+    for (int i = 0; i < nb_rows; i++){
+        double a = at(i, j);
+        if (i == r || a == 0){
+            continue;
+        }
+        double* row_i = &T[(size_t) i * nb_cols];
+        for (int k = 0; k < nb_cols; k++){
+            row_i[k] -= a * row_r[k];
+        }
+        row_i[j] = 0;
+        rhs[i] -= a * rhs[r];
+    }
+
+    double dj = d[j];
+    if (dj != 0){
+        for (int k = 0; k < nb_cols; k++){
+            d[k] -= dj * row_r[k];
+        }
+        d[j] = 0;
+        z += dj * rhs[r];
+    }
+
+    pos[basis[r]] = -1;
+    basis[r] = j;
+    pos[j] = r;
+}
+
+
+void Lp_Relaxation::complement(int j)
+{
+    double u = upper[j];
+    for (int i = 0; i < nb_rows; i++){
+        double& a = at(i, j);
+        if (a != 0){
+            rhs[i] -= a * u;
+            a = -a;
+        }
+    }
+    z += d[j] * u;
+    d[j] = -d[j];
+    comp[j] ^= 1;
+}
+
+
+void Lp_Relaxation::complement_basic(int r)
+{
+    // x_l = u - x'_l : la ligne r est multipliée par -1
+    int l = basis[r];
+    double* row_r = &T[(size_t) r * nb_cols];
+    for (int k = 0; k < nb_cols; k++){
+        row_r[k] = -row_r[k];
+    }
+    row_r[l] = 1;
+    rhs[r] = upper[l] - rhs[r];
+    comp[l] ^= 1;
+}
+
+
+// Itérations du simplexe primal jusqu'à l'optimum de l'objectif courant.
+// Les artificielles ne rentrent jamais en base. Renvoie false si non borné.
+bool Lp_Relaxation::run()
+{
+    long max_iterations = 1000000L + 100L * (nb_rows + nb_cols);
+    int degenerate = 0;
+
+    for (long it = 0; it < max_iterations; it++){
+        // variable entrante : plus grand coût réduit, ou Bland si dégénérescence
+        int j = -1;
+        double best = COST_EPS;
+        for (int k = 0; k < first_artificial; k++){
+            if (pos[k] < 0 && upper[k] > 0 && d[k] > best){
+                j = k;
+                if (degenerate >= DEGENERATE_STREAK){
+                    break;
+                }
+                best = d[k];
+            }
+        }
+        if (j < 0){
+            return true;
+        }
+
+        // test du ratio, borne propre de la variable entrante comprise
+        double t_max = upper[j];
+        int leave = -1;
+        bool to_upper = false;
+        for (int i = 0; i < nb_rows; i++){
+            double a = at(i, j);
+            int b = basis[i];
+            double t;
+            bool up;
+            if (a > PIVOT_EPS){
+                t = rhs[i] / a;
+                up = false;
+            }
+            else if (a < -PIVOT_EPS && upper[b] < SOLVER_INFINITY){
+                t = (upper[b] - rhs[i]) / -a;
+                up = true;
+            }
+            else {
+                continue;
+            }
+            t = max(t, 0.0);
+            if (t < t_max || (t == t_max && leave >= 0 && b < basis[leave])){
+                t_max = t;
+                leave = i;
+                to_upper = up;
+            }
+        }
+
+        if (leave < 0 && t_max >= SOLVER_INFINITY){
+            return false;
+        }
+        degenerate = t_max <= PIVOT_EPS ? degenerate + 1 : 0;
+
+        if (leave < 0){
+            complement(j);
+        }
+        else {
+            if (to_upper){
+                complement_basic(leave);
+            }
+            pivot(leave, j);
+        }
+    }
+    throw runtime_error("Solveur natif : limite d'iterations du simplexe atteinte");
+}
+
+
+Lp_Status Lp_Relaxation::solve(const vector<Native_Backend::Row>& model_rows, const vector<double>& objective,
+                               const vector<double>& var_upper, const vector<signed char>& fix,
+                               vector<double>& x, double& value, vector<double>* duals)
+{
+    int nb_vars = (int) fix.size();
+
+    // numérotation des variables libres
+    vector<int> column(nb_vars, -1);
+    vector<int> free_vars;
+    double fixed_value = 0;
+    for (int j = 0; j < nb_vars; j++){
+        if (fix[j] < 0){
+            column[j] = (int) free_vars.size();
+            free_vars.push_back(j);
+        }
+        else if (fix[j] == 1){
+            fixed_value += objective[j];
+        }
+    }
+    int nb_free = (int) free_vars.size();
+
+    // lignes "sum a.x + s = rhs", s >= 0 : une par borne finie
+    struct Lp_Row { const Native_Backend::Row* row; double sign; double rhs; };
+    vector<Lp_Row> lp_rows;
+    for (const auto& row : model_rows){
+        double constant = 0;
+        bool has_free = false;
+        for (size_t k = 0; k < row.vars.size(); k++){
+            int j = row.vars[k];
+            if (fix[j] < 0){
+                has_free = true;
+            }
+            else if (fix[j] == 1){
+                constant += row.coefs[k];
+            }
+        }
+        if (!has_free){
+            if (constant > row.ub + row_tolerance(row.ub) || constant < row.lb - row_tolerance(row.lb)){
+                return Lp_Status::INFEASIBLE;
+            }
+            continue;
+        }
+        if (row.ub < SOLVER_INFINITY){
+            lp_rows.push_back({ &row, 1, row.ub - constant });
+        }
+        if (row.lb > -SOLVER_INFINITY){
+            lp_rows.push_back({ &row, -1, constant - row.lb });
+        }
+    }
+
+    nb_rows = (int) lp_rows.size();
+    int nb_artificial = 0;
+    for (const auto& r : lp_rows){
+        nb_artificial += r.rhs < 0;
+    }
+    first_artificial = nb_free + nb_rows;
+    nb_cols = first_artificial + nb_artificial;
+
+    T.assign((size_t) nb_rows * nb_cols, 0);
+    rhs.assign(nb_rows, 0);
+    upper.assign(nb_cols, SOLVER_INFINITY);
+    d.assign(nb_cols, 0);
+    basis.assign(nb_rows, -1);
+    pos.assign(nb_cols, -1);
+    comp.assign(nb_cols, 0);
+    z = 0;
+    for (int k = 0; k < nb_free; k++){
+        upper[k] = var_upper[free_vars[k]];
+    }
+
+    // base de départ : les écarts, ou une artificielle si le second membre
+    // est négatif (ligne multipliée par -1)
+    int art = first_artificial;
+    for (int i = 0; i < nb_rows; i++){
+        const Lp_Row& r = lp_rows[i];
+        double sign = r.rhs < 0 ? -1 : 1;
+        for (size_t k = 0; k < r.row->vars.size(); k++){
+            int c = column[r.row->vars[k]];
+            if (c >= 0){
+                at(i, c) += sign * r.sign * r.row->coefs[k];
+            }
+        }
+        at(i, nb_free + i) = sign;
+        rhs[i] = sign * r.rhs;
+        int b = nb_free + i;
+        if (sign < 0){
+            b = art++;
+            at(i, b) = 1;
+        }
+        basis[i] = b;
+        pos[b] = i;
+    }
+
+    // Phase 1 : max -sum des artificielles
+    if (nb_artificial > 0){
+        double total = 0;
+        for (int i = 0; i < nb_rows; i++){
+            if (basis[i] >= first_artificial){
+                total += rhs[i];
+                for (int k = 0; k < first_artificial; k++){
+                    d[k] += at(i, k);
+                }
+            }
+        }
+        z = -total;
+        run();
+        if (z < -FEAS_EPS * max(1.0, total)){
+            return Lp_Status::INFEASIBLE;
+        }
+        for (int k = first_artificial; k < nb_cols; k++){
+            upper[k] = 0;
+        }
+    }
+
+    // Phase 2 : objectif réel, exprimé sur les variables complémentées
+    vector<double> c(nb_cols, 0);
+    z = 0;
+    for (int k = 0; k < nb_free; k++){
+        double cj = objective[free_vars[k]];
+        if (comp[k]){
+            z += cj * upper[k];
+            cj = -cj;
+        }
+        c[k] = cj;
+    }
+    d = c;
+    for (int i = 0; i < nb_rows; i++){
+        double cb = c[basis[i]];
+        if (cb == 0){
+            continue;
+        }
+        z += cb * rhs[i];
+        for (int k = 0; k < nb_cols; k++){
+            d[k] -= cb * at(i, k);
+        }
+    }
+    if (!run()){
+        return Lp_Status::UNBOUNDED;
+    }
+
+    x.assign(nb_vars, 0);
+    for (int j = 0; j < nb_vars; j++){
+        if (fix[j] >= 0){
+            x[j] = fix[j];
+            continue;
+        }
+        int k = column[j];
+        double v = pos[k] >= 0 ? rhs[pos[k]] : 0;
+        if (comp[k]){
+            v = upper[k] - v;
+        }
+        x[j] = min(var_upper[j], max(0.0, v));
+    }
+    value = z + fixed_value;
+
+    // Dual de la ligne i : moins le coût réduit de son écart (l'écart n'est
+    // jamais complémenté) ; une ligne ">= lb" a été écrite "-a.x <= -lb"
+    if (duals){
+        duals->assign(model_rows.size(), 0);
+        for (int i = 0; i < nb_rows; i++){
+            (*duals)[lp_rows[i].row - model_rows.data()] += lp_rows[i].sign * -d[nb_free + i];
+        }
+    }
+    return Lp_Status::OPTIMAL;
+}
+
+}
+
+
+Native_Backend::Native_Backend(const Options& opt)
+    : time_limit(opt.time_limit)
+{
+}
+
+
+void Native_Backend::add_variables(int n)
+{
+    for (int k = 0; k < n; k++)
+        column_start.push_back(nb_vars + k + 1);
+    nb_vars += n;
+    objective.resize(nb_vars, 0);
+    var_upper.resize(nb_vars, 1);
+    integer.resize(nb_vars, 1);
+}
+
+
+void Native_Backend::add_continuous_variables(int n, double ub)
+{
+    for (int k = 0; k < n; k++)
+        column_start.push_back(nb_vars + k + 1);
+    nb_vars += n;
+    objective.resize(nb_vars, 0);
+    var_upper.resize(nb_vars, ub);
+    integer.resize(nb_vars, 0);
+}
+
+
+void Native_Backend::add_integer_variables(int n, int ub)
+{
+    for (int k = 0; k < n; k++){
+        int first = nb_vars;
+        nb_vars += max(0, ub);
+        column_start.push_back(nb_vars);
+        objective.resize(nb_vars, 0);
+        var_upper.resize(nb_vars, 1);
+        integer.resize(nb_vars, 1);
+        for (int c = first; c + 1 < nb_vars; c++){
+            rows.push_back({ { c, c + 1 }, { 1, -1 }, 0, SOLVER_INFINITY });
+        }
+    }
+    expanded = expanded || ub != 1;
+}
+
+
+// Valeurs par colonne interne d'un vecteur indexé par variable (une
+// variable entière v donne ses v premières binaires à 1)
+vector<double> Native_Backend::to_columns(const vector<double>& values) const
+{
+    if (!expanded)
+        return values;
+    vector<double> x(nb_vars, 0);
+    for (size_t j = 0; j + 1 < column_start.size() && j < values.size(); j++){
+        int first = column_start[j], count = column_start[j + 1] - first;
+        if (count == 1){
+            x[first] = values[j];
+            continue;
+        }
+        int v = (int) floor(values[j] + 0.5);
+        for (int c = 0; c < count && c < v; c++)
+            x[first + c] = 1;
+    }
+    return x;
+}
+
+
+vector<double> Native_Backend::to_variables(const vector<double>& x) const
+{
+    if (!expanded || x.empty())
+        return x;
+    vector<double> values(column_start.size() - 1, 0);
+    for (size_t j = 0; j < values.size(); j++){
+        for (int c = column_start[j]; c < column_start[j + 1]; c++)
+            values[j] += x[c];
+    }
+    return values;
+}
+
+
+int Native_Backend::add_row(const vector<int>& vars, const vector<double>& coefs, double lb, double ub)
+{
+    if (!expanded){
+        rows.push_back({ vars, coefs, lb, ub });
+        return (int) rows.size() - 1;
+    }
+    Row row = { {}, {}, lb, ub };
+    for (size_t k = 0; k < vars.size(); k++){
+        for (int c = column_start[vars[k]]; c < column_start[vars[k] + 1]; c++){
+            row.vars.push_back(c);
+            row.coefs.push_back(coefs[k]);
+        }
+    }
+    rows.push_back(row);
+    return (int) rows.size() - 1;
+}
+
+
+void Native_Backend::set_row_bounds(int row, double lb, double ub)
+{
+    rows[row].lb = lb;
+    rows[row].ub = ub;
+}
+
+
+int Native_Backend::add_column(double obj, const vector<int>& col_rows, const vector<double>& coefs)
+{
+    for (size_t k = 0; k < col_rows.size(); k++){
+        rows[col_rows[k]].vars.push_back(nb_vars);
+        rows[col_rows[k]].coefs.push_back(coefs[k]);
+    }
+    objective.push_back(obj);
+    var_upper.push_back(1);
+    integer.push_back(1);
+    column_start.push_back(nb_vars + 1);
+    nb_vars++;
+    return (int) column_start.size() - 2;
+}
+
+
+void Native_Backend::set_objective(const vector<double>& coefs)
+{
+    if (!expanded){
+        objective = coefs;
+        objective.resize(nb_vars, 0);
+        return;
+    }
+    objective.assign(nb_vars, 0);
+    for (size_t j = 0; j + 1 < column_start.size() && j < coefs.size(); j++){
+        for (int c = column_start[j]; c < column_start[j + 1]; c++)
+            objective[c] = coefs[j];
+    }
+}
+
+
+void Native_Backend::add_start(const vector<double>& values, bool keep)
+{
+    starts.resize(nb_kept_starts);
+    starts.push_back(to_columns(values));
+    if (keep){
+        nb_kept_starts++;
+    }
+}
+
+
+bool Native_Backend::is_feasible(const vector<double>& x) const
+{
+    for (const auto& row : rows){
+        double s = 0;
+        for (size_t k = 0; k < row.vars.size(); k++){
+            s += row.coefs[k] * x[row.vars[k]];
+        }
+        if (s > row.ub + row_tolerance(row.ub) || s < row.lb - row_tolerance(row.lb)){
+            return false;
+        }
+    }
+    return true;
+}
+
+
+double Native_Backend::evaluate(const vector<double>& x) const
+{
+    double v = 0;
+    for (int j = 0; j < nb_vars; j++){
+        v += objective[j] * x[j];
+    }
+    return v;
+}
+
+
+// Renforcement des lignes avant le branch-and-bound (les variables sont
+// binaires) :
+//    - coefficients entiers de pgcd g : l'activité est un multiple de g, les
+//      bornes sont arrondies au multiple de g intérieur ;
+//    - ligne "<= ub" à coefficients positifs : les plus grands coefficients
+//      a_1 >= ... >= a_p tels que a_(p-1) + a_p > ub s'excluent deux à deux,
+//      d'où la coupe de clique sum_(k <= p) x_k <= 1 (par exemple : deux
+//      formats qui ne tiennent pas ensemble dans un écran).
+vector<Native_Backend::Row> Native_Backend::strengthened_rows() const
+{
+    // les deux renforcements supposent toutes les variables de la ligne binaires
+    auto binary_row = [&](const Row& row){
+        for (int j : row.vars){
+            if (!integer[j])
+                return false;
+        }
+        return true;
+    };
+
+    vector<Row> res = rows;
+    for (const auto& row : rows){
+        if (row.ub >= SOLVER_INFINITY || row.vars.size() < 2 || !binary_row(row)){
+            continue;
+        }
+        vector<pair<double, int>> items;
+        bool positive = true;
+        for (size_t k = 0; k < row.vars.size(); k++){
+            positive = positive && row.coefs[k] >= 0;
+            items.push_back({ row.coefs[k], row.vars[k] });
+        }
+        if (!positive){
+            continue;
+        }
+        sort(items.begin(), items.end(), greater<pair<double, int>>());
+        size_t p = 1;
+        while (p < items.size() && items[p - 1].first + items[p].first > row.ub + row_tolerance(row.ub)){
+            p++;
+        }
+        if (p >= 2){
+            Row clique = { {}, {}, -SOLVER_INFINITY, 1 };
+            for (size_t k = 0; k < p; k++){
+                clique.vars.push_back(items[k].second);
+                clique.coefs.push_back(1);
+            }
+            res.push_back(clique);
+        }
+    }
+
+    for (auto& row : res){
+        long long g = 0;
+        bool integral = binary_row(row);
+        for (double c : row.coefs){
+            integral = integral && c == floor(c) && fabs(c) < 1e15;
+            if (integral){
+                g = gcd(g, (long long) fabs(c));
+            }
+        }
+        if (!integral || g <= 1){
+            continue;
+        }
+        if (row.ub < SOLVER_INFINITY){
+            row.ub = g * floor(row.ub / g + FEAS_EPS);
+        }
+        if (row.lb > -SOLVER_INFINITY){
+            row.lb = g * ceil(row.lb / g - FEAS_EPS);
+        }
+    }
+    return res;
+}
+
+
+Solve_Status Native_Backend::solve()
+{
+    auto start = chrono::steady_clock::now();
+    auto elapsed = [&](){
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    };
+
+    first_incumbent = -1;
+    solution.clear();
+
+    // lignes de chaque variable, pour la complétion gloutonne
+    vector<vector<pair<int, double>>> var_rows(nb_vars);
+    for (size_t r = 0; r < rows.size(); r++){
+        for (size_t k = 0; k < rows[r].vars.size(); k++){
+            var_rows[rows[r].vars[k]].push_back({ (int) r, rows[r].coefs[k] });
+        }
+    }
+
+    // objectif à coefficients entiers sur les binaires et nuls sur les
+    // continues : une solution meilleure gagne au moins 1
+    bool integral = true;
+    bool has_continuous = false;
+    for (int j = 0; j < nb_vars; j++){
+        integral = integral && (integer[j] ? objective[j] == floor(objective[j]) : objective[j] == 0);
+        has_continuous = has_continuous || !integer[j];
+    }
+
+    vector<double> best;
+    double best_val = 0;
+    auto try_incumbent = [&](const vector<double>& x){
+        if (!is_feasible(x)){
+            return;
+        }
+        double v = evaluate(x);
+        if (best.empty() || v > best_val){
+            best = x;
+            best_val = v;
+            if (first_incumbent < 0){
+                first_incumbent = elapsed();
+            }
+        }
+    };
+    // Binaires fixées à leur valeur : les continues sont données par la
+    // relaxation restante
+    Lp_Relaxation fixed_lp;
+    vector<signed char> fixed(nb_vars);
+    vector<double> settled;
+    auto try_binaries = [&](const vector<double>& x){
+        if (!has_continuous){
+            try_incumbent(x);
+            return;
+        }
+        for (int j = 0; j < nb_vars; j++){
+            fixed[j] = integer[j] ? (x[j] > 0.5 ? 1 : 0) : -1;
+        }
+        double v;
+        if (fixed_lp.solve(rows, objective, var_upper, fixed, settled, v) == Lp_Status::OPTIMAL){
+            try_incumbent(settled);
+        }
+    };
+    auto pruned = [&](double bound){
+        if (best.empty()){
+            return false;
+        }
+        double tol = NATIVE_MIP_GAP * max(1.0, fabs(best_val));
+        if (integral){
+            tol = max(tol, 1 - FEAS_EPS);
+        }
+        return bound <= best_val + tol;
+    };
+
+    // Arrondi inférieur de la relaxation, puis le même complété en mettant à
+    // 1, par valeur de relaxation puis par coefficient d'objectif décroissants,
+    // les variables libres qui ne font dépasser aucune borne supérieure
+    vector<double> activity(rows.size());
+    vector<int> order(nb_vars);
+    auto round_and_complete = [&](const vector<double>& x, const vector<signed char>& fix){
+        vector<double> rounded(nb_vars);
+        fill(activity.begin(), activity.end(), 0.0);
+        for (int j = 0; j < nb_vars; j++){
+            rounded[j] = integer[j] && x[j] > 1 - FEAS_EPS ? 1 : 0;
+            if (rounded[j] > 0){
+                for (const auto& rc : var_rows[j]){
+                    activity[rc.first] += rc.second;
+                }
+            }
+        }
+        try_binaries(rounded);
+
+        for (int j = 0; j < nb_vars; j++){
+            order[j] = j;
+        }
+        sort(order.begin(), order.end(), [&](int a, int b){
+            return x[a] != x[b] ? x[a] > x[b] : objective[a] > objective[b];
+        });
+        for (int j : order){
+            if (!integer[j] || rounded[j] > 0 || fix[j] == 0 || objective[j] <= 0){
+                continue;
+            }
+            bool fits = true;
+            for (const auto& rc : var_rows[j]){
+                const Row& row = rows[rc.first];
+                if (activity[rc.first] + rc.second > row.ub + row_tolerance(row.ub)){
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits){
+                rounded[j] = 1;
+                for (const auto& rc : var_rows[j]){
+                    activity[rc.first] += rc.second;
+                }
+            }
+        }
+        try_binaries(rounded);
+    };
+
+    // une solution de départ peut ne donner que les premières variables
+    for (const auto& s : starts){
+        vector<double> x(nb_vars, 0);
+        for (int j = 0; j < nb_vars && j < (int) s.size(); j++){
+            x[j] = s[j] > 0.5 ? 1 : 0;
+        }
+        try_binaries(x);
+    }
+
+    // Meilleure borne d'abord, avec plongée : après un branchement, la
+    // branche x = 1 est traitée tout de suite et l'autre mise en attente
+    struct Node {
+        vector<signed char> fix;    // -1 libre, 0 ou 1 fixée
+        double bound;               // relaxation du père
+    };
+    auto lower_bound_first = [](const Node& a, const Node& b){ return a.bound < b.bound; };
+    vector<Node> open;
+
+    Lp_Relaxation lp;
+    vector<Row> lp_rows = strengthened_rows();
+    vector<double> x;
+    long nb_nodes = 0;
+    bool complete = true;
+
+    Node node = { vector<signed char>(nb_vars, -1), SOLVER_INFINITY };
+    bool has_node = true;
+
+    while (has_node || !open.empty()){
+        if (elapsed() > time_limit){
+            complete = false;
+            break;
+        }
+        if (!has_node){
+            pop_heap(open.begin(), open.end(), lower_bound_first);
+            node = std::move(open.back());
+            open.pop_back();
+        }
+        has_node = false;
+        if (pruned(node.bound)){
+            continue;
+        }
+        nb_nodes++;
+
+        double value = 0;
+        Lp_Status st = lp.solve(lp_rows, objective, var_upper, node.fix, x, value);
+        if (st == Lp_Status::INFEASIBLE){
+            continue;
+        }
+        if (st == Lp_Status::UNBOUNDED){
+            throw runtime_error("Solveur natif : relaxation non bornee");
+        }
+        if (pruned(value)){
+            continue;
+        }
+
+        // variable la plus fractionnaire
+        int branch = -1;
+        double branch_dist = FEAS_EPS;
+        for (int j = 0; j < nb_vars; j++){
+            double dist = min(x[j], 1 - x[j]);
+            if (integer[j] && node.fix[j] < 0 && dist > branch_dist){
+                branch = j;
+                branch_dist = dist;
+            }
+        }
+
+        // la solution elle-même si elle est entière, sinon son arrondi complété
+        round_and_complete(x, node.fix);
+        if (branch < 0){
+            continue;
+        }
+
+        Node zero = { node.fix, value };
+        zero.fix[branch] = 0;
+        open.push_back(std::move(zero));
+        push_heap(open.begin(), open.end(), lower_bound_first);
+
+        node.fix[branch] = 1;
+        node.bound = value;
+        has_node = true;
+    }
+
+    if (verbose){
+        cout << "Branch-and-bound natif : " << nb_nodes << " noeuds, " << elapsed() << " s"
+             << (complete ? "" : " (limite de temps)") << endl;
+    }
+
+    if (best.empty()){
+        return complete ? Solve_Status::INFEASIBLE : Solve_Status::UNKNOWN;
+    }
+    solution = to_variables(best);
+    objective_val = best_val;
+    return complete ? Solve_Status::OPTIMAL : Solve_Status::FEASIBLE;
+}
+
+
+Solve_Status Native_Backend::solve_relaxation()
+{
+    Lp_Relaxation lp;
+    solution.clear();
+    row_duals.clear();
+    Lp_Status st = lp.solve(rows, objective, var_upper, vector<signed char>(nb_vars, -1), solution, objective_val,
+                            &row_duals);
+    solution = to_variables(solution);
+    switch (st){
+        case Lp_Status::OPTIMAL:    return Solve_Status::OPTIMAL;
+        case Lp_Status::INFEASIBLE: return Solve_Status::INFEASIBLE;
+        default:                    return Solve_Status::UNBOUNDED;
+    }
+}
+
+
+void Native_Backend::export_model(const string& path)
+{
+    ofstream out(path);
+    if (!out){
+        throw runtime_error("Impossible d'ecrire " + path);
+    }
+    out.precision(17);
+
+    // une ligne LP ne doit pas dépasser 510 caractères
+    auto write_terms = [&](const vector<int>& vars, const vector<double>& coefs){
+        int n = 0;
+        for (size_t k = 0; k < vars.size(); k++){
+            if (coefs[k] == 0){
+                continue;
+            }
+            out << (coefs[k] < 0 ? " - " : " + ") << fabs(coefs[k]) << " x" << vars[k];
+            if (++n % 8 == 0){
+                out << "\n  ";
+            }
+        }
+        if (n == 0){
+            out << " 0 x0";
+        }
+    };
+
+    vector<int> all(nb_vars);
+    for (int j = 0; j < nb_vars; j++){
+        all[j] = j;
+    }
+
+    out << "\\ Modele d'allocation (solveur natif)\n";
+    out << "Maximize\n obj:";
+    write_terms(all, objective);
+    out << "\nSubject To\n";
+    for (size_t r = 0; r < rows.size(); r++){
+        const Row& row = rows[r];
+        bool has_lb = row.lb > -SOLVER_INFINITY, has_ub = row.ub < SOLVER_INFINITY;
+        if (has_lb && has_ub && row.lb == row.ub){
+            out << " r" << r << ":";
+            write_terms(row.vars, row.coefs);
+            out << " = " << row.ub << "\n";
+            continue;
+        }
+        if (has_ub){
+            out << " r" << r << (has_lb ? "_ub:" : ":");
+            write_terms(row.vars, row.coefs);
+            out << " <= " << row.ub << "\n";
+        }
+        if (has_lb){
+            out << " r" << r << (has_ub ? "_lb:" : ":");
+            write_terms(row.vars, row.coefs);
+            out << " >= " << row.lb << "\n";
+        }
+    }
+    out << "Bounds\n";
+    for (int j = 0; j < nb_vars; j++){
+        if (!integer[j])
+            out << " 0 <= x" << j << " <= " << var_upper[j] << "\n";
+    }
+    out << "Binaries\n";
+    int nb_binaries = 0;
+    for (int j = 0; j < nb_vars; j++){
+        if (integer[j])
+            out << " x" << j << (++nb_binaries % 16 == 0 ? "\n" : "");
+    }
+    out << "\nEnd\n";
+}
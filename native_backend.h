@@ -0,0 +1,105 @@
+/*
+ Solveur natif : branch-and-bound sur la relaxation linéaire.
+
+ Aucune dépendance : permet de résoudre le modèle d'allocation (et toute la
+ méthode d'epsilon-contrainte) sur une machine sans CPLEX.
+    - Relaxation : simplexe primal en deux phases sur tableau dense, variables
+      bornées (0 <= x <= 1) traitées par complémentation, règle de Bland en
+      cas de dégénérescence prolongée.
+    - Branch-and-bound par meilleure borne d'abord, avec plongée : on
+      branche sur la variable la plus fractionnaire, la branche x = 1 est
+      résolue tout de suite et la branche x = 0 rejoint les noeuds en
+      attente, dont on reprend celui de plus grande borne (celle de son
+      père) quand la plongée s'arrête. Un noeud est élagué dès que sa borne
+      ne dépasse plus la meilleure solution de plus de l'écart relatif
+      NATIVE_MIP_GAP (valeur par défaut de CPLEX).
+    - A chaque noeud, la solution de la relaxation arrondie à l'entier
+      inférieur est essayée comme solution réalisable.
+    - Les variables continues ne sont jamais branchées : une fois les
+      binaires fixées (arrondi, solution de départ), leurs valeurs sont
+      données par la relaxation restante.
+    - Les solutions de départ sont utilisées si elles sont réalisables (pas
+      de réparation).
+    - Une variable entière 0 <= x <= u devient u binaires ordonnées
+      b_1 >= ... >= b_u (x = sum b_k) : le branch-and-bound reste binaire
+      et chaque valeur de x n'a qu'une écriture. Les lignes, l'objectif, les
+      solutions de départ et les valeurs sont traduits à l'interface ; les
+      lignes d'ordre sont numérotées avec les autres.
+    - La relaxation seule (génération de colonnes) donne les valeurs duales
+      à partir des coûts réduits des variables d'écart.
+ Le tableau est dense : le solveur vise les petites et moyennes instances
+ (tests, machines sans licence), pas les instances de production.
+ */
+
+#ifndef NATIVE_BACKEND_H
+#define NATIVE_BACKEND_H
+
+#include "solver.h"
+
+const double NATIVE_MIP_GAP = 1e-4;
+
+class Native_Backend : public Solver_Backend {
+public:
+    explicit Native_Backend(const Options& opt);
+
+    std::string name() const override { return "native"; }
+
+    void add_variables(int n) override;
+    void add_continuous_variables(int n, double ub) override;
+    void add_integer_variables(int n, int ub) override;
+    int add_row(const std::vector<int>& vars, const std::vector<double>& coefs,
+                double lb, double ub) override;
+    void set_row_bounds(int row, double lb, double ub) override;
+    int add_column(double obj, const std::vector<int>& rows, const std::vector<double>& coefs) override;
+    void set_objective(const std::vector<double>& coefs) override;
+    void add_start(const std::vector<double>& values, bool keep) override;
+
+    Solve_Status solve() override;
+    Solve_Status solve_relaxation() override;
+    std::vector<double> duals() const override { return row_duals; }
+
+    double objective_value() const override { return objective_val; }
+    std::vector<double> values() const override { return solution; }
+    double first_incumbent_time() const override { return first_incumbent; }
+
+    int nb_variables() const override { return (int) column_start.size() - 1; }
+    int nb_rows() const override { return (int) rows.size(); }
+
+    void export_model(const std::string& path) override;
+    void quiet() override { verbose = false; }
+
+    struct Row {
+        std::vector<int> vars;
+        std::vector<double> coefs;
+        double lb;
+        double ub;
+    };
+
+private:
+    double time_limit;
+    bool verbose = true;
+
+    int nb_vars = 0;                    // colonnes internes
+    std::vector<int> column_start = { 0 };  // variable j : colonnes column_start[j] ..
+    bool expanded = false;              // au moins une variable entière
+    std::vector<double> var_upper;      // 1 pour une binaire
+    std::vector<char> integer;          // binaire, sinon continue
+    std::vector<Row> rows;
+    std::vector<double> objective;
+
+    std::vector<std::vector<double>> starts;
+    int nb_kept_starts = 0;
+
+    double objective_val = 0;
+    std::vector<double> solution;
+    std::vector<double> row_duals;
+    double first_incumbent = -1;
+
+    std::vector<double> to_columns(const std::vector<double>& values) const;
+    std::vector<double> to_variables(const std::vector<double>& x) const;
+    std::vector<Row> strengthened_rows() const;
+    bool is_feasible(const std::vector<double>& x) const;
+    double evaluate(const std::vector<double>& x) const;
+};
+
+#endif
@@ -0,0 +1,279 @@
+/*
+ Lecture des options de la ligne de commande et du manifeste des lots.
+ */
+
+#include "options.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string.h>
+
+using namespace std;
+
+
+namespace {
+
+// Valeur de l'option argv[k], k avancé d'un cran
+const char* option_value(int argc, char **argv, int& k)
+{
+    if (k + 1 >= argc){
+        throw runtime_error(string("Valeur manquante pour ") + argv[k]);
+    }
+    return argv[++k];
+}
+
+string directory_of(const string& path)
+{
+    size_t pos = path.find_last_of('/');
+    return pos == string::npos ? "" : path.substr(0, pos + 1);
+}
+
+string resolve(const string& dir, const string& path)
+{
+    return path.empty() || path[0] == '/' ? path : dir + path;
+}
+
+vector<Instance_Files> read_manifest(const string& manifest, const string& out_dir)
+{
+    ifstream in(manifest);
+    if (!in){
+        throw runtime_error("Impossible d'ouvrir le manifeste " + manifest);
+    }
+    string dir = directory_of(manifest);
+
+    vector<Instance_Files> instances;
+    string line;
+    int line_no = 0;
+    while (getline(in, line)){
+        line_no++;
+        istringstream fields(line);
+        Instance_Files files;
+        if (!(fields >> files.break_path) || files.break_path[0] == '#'){
+            continue;
+        }
+        if (!(fields >> files.brand_path)){
+            throw runtime_error(manifest + ":" + to_string(line_no) + " : fichier des marques manquant");
+        }
+        fields >> files.out_dir;
+
+        files.break_path = resolve(dir, files.break_path);
+        files.brand_path = resolve(dir, files.brand_path);
+        if (!files.out_dir.empty()){
+            files.out_dir = resolve(dir, files.out_dir);
+        }
+        else if (!out_dir.empty()){
+            files.out_dir = out_dir + "/" + to_string(instances.size());
+        }
+        instances.push_back(files);
+    }
+    if (instances.empty()){
+        throw runtime_error("Le manifeste " + manifest + " ne contient aucune instance");
+    }
+    return instances;
+}
+
+}
+
+
+Options parse_options(int argc, char **argv)
+{
+    Options opt;
+    Instance_Files single;
+    string manifest;
+
+    for (int k = 1; k < argc; k++){
+        const char* arg = argv[k];
+        if (!strcmp(arg, "-b") || !strcmp(arg, "--breaks")){
+            single.break_path = option_value(argc, argv, k);
+        }
+        else if (!strcmp(arg, "-m") || !strcmp(arg, "--brands")){
+            single.brand_path = option_value(argc, argv, k);
+        }
+        else if (!strcmp(arg, "-o") || !strcmp(arg, "--out")){
+            single.out_dir = option_value(argc, argv, k);
+        }
+        else if (!strcmp(arg, "-c") || !strcmp(arg, "--cache")){
+            single.cache_path = option_value(argc, argv, k);
+        }
+        else if (!strcmp(arg, "-s") || !strcmp(arg, "--solver")){
+            opt.solver = option_value(argc, argv, k);
+            if (opt.solver != "cplex" && opt.solver != "native"){
+                throw runtime_error("Solveur inconnu : " + opt.solver + " (cplex ou native)");
+            }
+        }
+        else if (!strcmp(arg, "-t") || !strcmp(arg, "--time-limit")){
+            opt.time_limit = atof(option_value(argc, argv, k));
+            if (opt.time_limit <= 0){
+                throw runtime_error("La limite de temps doit etre positive");
+            }
+        }
+        else if (!strcmp(arg, "-j") || !strcmp(arg, "--threads")){
+            opt.threads = atoi(option_value(argc, argv, k));
+            if (opt.threads < 0){
+                throw runtime_error("Le nombre de threads doit etre positif (0 = automatique)");
+            }
+        }
+        else if (!strcmp(arg, "-p") || !strcmp(arg, "--parallel")){
+            opt.parallel = atoi(option_value(argc, argv, k));
+            if (opt.parallel < 0){
+                throw runtime_error("Le nombre de resolutions paralleles doit etre positif");
+            }
+        }
+        else if (!strcmp(arg, "--intervals")){
+            opt.intervals = atoi(option_value(argc, argv, k));
+            if (opt.intervals <= 0){
+                throw runtime_error("Le nombre d'intervalles doit etre strictement positif");
+            }
+        }
+        else if (!strcmp(arg, "--epsilon-step")){
+            opt.epsilon_step = atof(option_value(argc, argv, k));
+            if (opt.epsilon_step < 0){
+                throw runtime_error("Le pas d'epsilon doit etre positif");
+            }
+        }
+        else if (!strcmp(arg, "--objectives")){
+            opt.objectives = atoi(option_value(argc, argv, k));
+            if (opt.objectives != 2 && opt.objectives != 4){
+                throw runtime_error("Le nombre d'objectifs doit etre 2 ou 4");
+            }
+        }
+        else if (!strcmp(arg, "--grid")){
+            opt.grid = atoi(option_value(argc, argv, k));
+            if (opt.grid < 2){
+                throw runtime_error("La grille doit compter au moins 2 valeurs par objectif");
+            }
+        }
+        else if (!strcmp(arg, "--quadratic-competitors")){
+            opt.quadratic_competitors = true;
+        }
+        else if (!strcmp(arg, "--slots")){
+            opt.slots = true;
+        }
+        else if (!strcmp(arg, "--no-presolve")){
+            opt.presolve = false;
+        }
+        else if (!strcmp(arg, "--aggregate")){
+            opt.aggregate = true;
+        }
+        else if (!strcmp(arg, "--cold-start")){
+            opt.warm_start = false;
+        }
+        else if (!strcmp(arg, "--greedy")){
+            opt.greedy_only = true;
+        }
+        else if (!strcmp(arg, "--local-search")){
+            opt.local_search = atof(option_value(argc, argv, k));
+            if (opt.local_search < 0){
+                throw runtime_error("La duree de la recherche locale doit etre positive");
+            }
+        }
+        else if (!strcmp(arg, "--bounds")){
+            opt.lagrangian_bounds = true;
+        }
+        else if (!strcmp(arg, "--colgen")){
+            opt.column_generation = true;
+        }
+        else if (!strcmp(arg, "--decompose")){
+            opt.decompose = atoi(option_value(argc, argv, k));
+            if (opt.decompose <= 0){
+                throw runtime_error("Le nombre de tours de la decomposition doit etre strictement positif");
+            }
+        }
+        else if (!strcmp(arg, "--window")){
+            opt.window = atof(option_value(argc, argv, k));
+            if (opt.window <= 0){
+                throw runtime_error("La longueur des fenetres doit etre strictement positive");
+            }
+        }
+        else if (!strcmp(arg, "--overlap")){
+            opt.overlap = atof(option_value(argc, argv, k));
+            if (opt.overlap < 0){
+                throw runtime_error("Le recouvrement des fenetres doit etre positif");
+            }
+        }
+        else if (!strcmp(arg, "--batch")){
+            manifest = option_value(argc, argv, k);
+        }
+        else {
+            throw runtime_error(string("Option inconnue : ") + arg);
+        }
+    }
+
+    if (opt.objectives == 4 && opt.parallel > 0){
+        throw runtime_error("--objectives 4 ne se combine pas avec --parallel");
+    }
+    if (opt.slots && opt.quadratic_competitors){
+        throw runtime_error("--slots ne se combine pas avec --quadratic-competitors");
+    }
+    if (opt.aggregate && (opt.slots || opt.quadratic_competitors || !opt.presolve)){
+        throw runtime_error("--aggregate ne se combine pas avec --slots, --quadratic-competitors ni --no-presolve");
+    }
+    if (opt.decompose > 0 && opt.column_generation){
+        throw runtime_error("--decompose ne se combine pas avec --colgen");
+    }
+    if (opt.overlap > 0 && opt.window == 0){
+        throw runtime_error("--overlap demande --window");
+    }
+    if (opt.window > 0 && opt.overlap >= opt.window){
+        throw runtime_error("Le recouvrement doit etre plus court que les fenetres");
+    }
+    if (opt.window > 0 && (opt.window - opt.overlap) * 86400 < 1){
+        throw runtime_error("Les fenetres doivent etre decalees d'au moins une seconde (--window - --overlap)");
+    }
+    if (opt.window > 0 && (opt.decompose > 0 || opt.column_generation)){
+        throw runtime_error("--window ne se combine pas avec --decompose ni --colgen");
+    }
+
+    if (!manifest.empty()){
+        if (!single.break_path.empty() || !single.brand_path.empty() || !single.cache_path.empty()){
+            throw runtime_error("--batch ne se combine pas avec -b, -m ou -c");
+        }
+        opt.instances = read_manifest(manifest, single.out_dir);
+    }
+    else {
+        if (single.break_path.empty() || single.brand_path.empty()){
+            throw runtime_error("Les fichiers des ecrans (-b) et des marques (-m) sont obligatoires");
+        }
+        opt.instances.push_back(single);
+    }
+    return opt;
+}
+
+
+string usage(const char* program)
+{
+    string p = program;
+    return "Utilisation :\n"
+           "  " + p + " -b <ecrans> -m <marques> [options]\n"
+           "  " + p + " --batch <manifeste> [options]\n"
+           "\n"
+           "  -b, --breaks FICHIER      ecrans publicitaires (JSON, CBOR, MessagePack ou BSON)\n"
+           "  -m, --brands FICHIER      marques\n"
+           "  -c, --cache FICHIER       cache binaire de l'instance (reconstruit si les sources changent)\n"
+           "  -o, --out DOSSIER         export des modeles .lp (en lot : un sous-dossier par instance)\n"
+           "  -s, --solver NOM          cplex, ou native (branch-and-bound integre, sans licence)\n"
+           "  -t, --time-limit S        limite de temps de chaque resolution (defaut 3600)\n"
+           "  -j, --threads N           threads du solveur (defaut 1, 0 = automatique)\n"
+           "  -p, --parallel N          explore le front avec N resolutions simultanees\n"
+           "      --intervals K         decoupage du revenu en K intervalles (defaut 4 x N)\n"
+           "      --epsilon-step S      pas de la grille du revenu TV (defaut 1 : tout le front)\n"
+           "      --objectives N        2 (revenu TV, GRP) ou 4 (+ ecart au ratio prime, priorite)\n"
+           "      --grid K              valeurs d'epsilon par objectif contraint avec 4 objectifs (defaut 5)\n"
+           "      --batch MANIFESTE     resout les instances du manifeste dans le meme processus\n"
+           "      --quadratic-competitors\n"
+           "                            une contrainte par paire de marques concurrentes\n"
+           "      --slots               une variable par position disponible (normal_1 .. normal_5)\n"
+           "      --no-presolve         modele complet, sans elimination de couples ni de contraintes\n"
+           "      --aggregate           ecrans interchangeables agreges en variables entieres\n"
+           "      --cold-start          pas de MIP start a partir des solutions precedentes\n"
+           "      --greedy              allocations gloutonnes seulement (GRP/s et revenu/s)\n"
+           "      --local-search S      ameliore chaque allocation gloutonne pendant S secondes\n"
+           "      --bounds              bornes superieures par relaxation lagrangienne des budgets\n"
+           "      --colgen              mono-objectifs par generation de colonnes (grandes instances)\n"
+           "      --decompose R         mono-objectifs station par station (-j en parallele),\n"
+           "                            R tours de coordination des budgets\n"
+           "      --window D            mono-objectifs par horizon glissant, fenetres de D jours\n"
+           "      --overlap D           recouvrement des fenetres successives (jours, defaut 0)\n";
+}
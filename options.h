@@ -0,0 +1,109 @@
+/*
+ Options de la ligne de commande.
+
+    spots -b break.json -m brands.json [-o dossier] [-t secondes] [-j threads] [-c cache]
+    spots --batch manifeste [-o dossier] [-t secondes] [-j threads]
+    spots -h
+
+ Le manifeste d'un lot contient une instance par ligne :
+    <fichier écrans> <fichier marques> [dossier de sortie]
+ Les lignes vides et celles commençant par '#' sont ignorées ; les chemins
+ relatifs sont pris par rapport au dossier du manifeste.
+ */
+
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <string>
+#include <vector>
+
+// Une instance à résoudre
+struct Instance_Files {
+    std::string break_path;
+    std::string brand_path;
+    std::string out_dir;        // export des modèles .lp, vide = pas d'export
+    std::string cache_path;     // cache binaire, vide = pas de cache
+};
+
+struct Options {
+    std::vector<Instance_Files> instances;
+
+    // Solveur : "cplex" ou "native" (voir solver.h)
+#ifdef NO_CPLEX
+    std::string solver = "native";
+#else
+    std::string solver = "cplex";
+#endif
+
+    double time_limit = 3600;   // TiLim de chaque résolution (s)
+    int threads = 1;            // Threads de CPLEX (par résolution)
+
+    // Exploration parallèle du front : nombre de résolutions simultanées
+    // (0 = boucle d'epsilon séquentielle) et nombre d'intervalles de revenu
+    // (0 = 4 par résolution simultanée, pour équilibrer la charge)
+    int parallel = 0;
+    int intervals = 0;
+
+    // Pas de la grille d'epsilon sur le revenu TV de la boucle séquentielle
+    // (0 = 1, tous les points du front)
+    double epsilon_step = 0;
+
+    // Nombre d'objectifs : 2 (revenu TV, GRP) ou 4 (+ écart au ratio prime,
+    // priorité), avec grid valeurs d'epsilon par objectif contraint
+    int objectives = 2;
+    int grid = 5;
+
+    // Ancienne formulation des marques concurrentes, une contrainte par paire
+    // (x_ij1 + x_ij2 <= 1, linéarisation de x_ij1 * x_ij2 = 0), pour comparaison
+    bool quadratic_competitors = false;
+
+    // Variables par position (écran, normal_1 .. normal_5, marque), au prix
+    // de la position, pour les seules positions disponibles
+    bool slots = false;
+
+    // Presolve du modèle exact (couples impossibles, contraintes redondantes,
+    // variables fixées ; voir presolve.h)
+    bool presolve = true;
+
+    // Agrégation des écrans interchangeables en variables entières (presolve)
+    bool aggregate = false;
+
+    // Solutions précédentes (et allocations gloutonnes) données au solveur
+    // comme MIP starts (false = départ à froid)
+    bool warm_start = true;
+
+    // Uniquement les allocations gloutonnes, sans résolution exacte
+    bool greedy_only = false;
+
+    // Amélioration des allocations gloutonnes par recherche locale (s, temps
+    // réel par allocation ; 0 = pas de recherche locale)
+    double local_search = 0;
+
+    // Bornes supérieures du revenu TV et du GRP par relaxation lagrangienne
+    // des budgets (écart des allocations gloutonnes à l'optimum)
+    bool lagrangian_bounds = false;
+
+    // Mono-objectifs revenu TV et GRP par génération de colonnes sur les
+    // combinaisons de marques des écrans, à la place du modèle x_ij
+    bool column_generation = false;
+
+    // Mono-objectifs revenu TV et GRP par décomposition par station
+    // (decomposition.h) : nombre de tours de coordination des budgets
+    // (0 = pas de décomposition)
+    int decompose = 0;
+
+    // Mono-objectifs revenu TV et GRP par horizon glissant sur start_date
+    // (rolling.h) : longueur des fenêtres et recouvrement de deux fenêtres
+    // successives, en jours (window = 0 : pas d'horizon glissant)
+    double window = 0;
+    double overlap = 0;
+};
+
+// Lit argv. Lève std::runtime_error (message destiné à l'utilisateur) en cas
+// d'option invalide ou de manifeste illisible.
+Options parse_options(int argc, char **argv);
+
+// Texte d'aide
+std::string usage(const char* program);
+
+#endif
@@ -0,0 +1,379 @@
+/*
+ Archive des points de Pareto : index trié (2 objectifs) ou arbre de boîtes.
+ */
+
+#include "pareto.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+
+vector<uint64_t> pack_allocation(const vector<double>& values, size_t nb_bits)
+{
+    vector<uint64_t> x((nb_bits + 63) / 64, 0);
+    for (size_t k = 0; k < nb_bits && k < values.size(); k++){
+        if (values[k] > 0.5)
+            x[k / 64] |= uint64_t(1) << (k % 64);
+    }
+    return x;
+}
+
+
+bool dominates(const Pareto_Point& a, const Pareto_Point& b, int nb_objectives)
+{
+    bool better = false;
+    for (int k = 0; k < nb_objectives; k++){
+        if (a.objectives[k] < b.objectives[k] - PARETO_EPS)
+            return false;
+        better |= a.objectives[k] > b.objectives[k] + PARETO_EPS;
+    }
+    return better;
+}
+
+
+// a vaut au moins b à PARETO_EPS près partout : doublon ou domination
+static bool weakly_dominates(const Pareto_Point& a, const Pareto_Point& b, int nb_objectives)
+{
+    for (int k = 0; k < nb_objectives; k++){
+        if (a.objectives[k] < b.objectives[k] - PARETO_EPS)
+            return false;
+    }
+    return true;
+}
+
+
+// FNV-1a sur les mots du bitmap
+static uint64_t allocation_hash(const vector<uint64_t>& x)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (uint64_t w : x){
+        h ^= w;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+
+Pareto_Archive::Pareto_Archive(int nb_objectives) : dim(nb_objectives)
+{
+    if (dim < 2 || dim > PARETO_MAX_OBJECTIVES){
+        throw invalid_argument("Archive de Pareto : 2 a 4 objectifs");
+    }
+}
+
+
+bool Pareto_Archive::same_allocation_locked(const Pareto_Point& p, uint64_t h) const
+{
+    auto it = by_allocation.find(h);
+    if (it == by_allocation.end())
+        return false;
+    for (int id : it->second){
+        if (store[id].x == p.x)
+            return true;
+    }
+    return false;
+}
+
+
+bool Pareto_Archive::covered_locked(const Pareto_Point& p) const
+{
+    if (!p.x.empty() && same_allocation_locked(p, allocation_hash(p.x)))
+        return true;
+
+    if (dim == 2){
+        // Premier point de revenu >= celui de p : GRP maximal parmi eux
+        auto it = sorted.lower_bound(p.objectives[0] - PARETO_EPS);
+        return it != sorted.end() && store[it->second].objectives[1] >= p.objectives[1] - PARETO_EPS;
+    }
+
+    // Sous-arbres dont le max atteint p partout
+    vector<int> stack;
+    if (!nodes.empty())
+        stack.push_back(0);
+    while (!stack.empty()){
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+        bool reach = true;
+        for (int k = 0; k < dim && reach; k++)
+            reach = node.high[k] >= p.objectives[k] - PARETO_EPS;
+        if (!reach)
+            continue;
+        if (node.child[0] >= 0){
+            stack.push_back(node.child[0]);
+            stack.push_back(node.child[1]);
+            continue;
+        }
+        for (int id : node.ids){
+            if (alive[id] && weakly_dominates(store[id], p, dim))
+                return true;
+        }
+    }
+    return false;
+}
+
+
+void Pareto_Archive::remove_dominated(const Pareto_Point& p)
+{
+    auto kill = [&](int id){
+        alive[id] = 0;
+        nb_alive--;
+    };
+
+    if (dim == 2){
+        // Revenu <= celui de p : GRP croissant en remontant
+        auto it = sorted.upper_bound(p.objectives[0] + PARETO_EPS);
+        while (it != sorted.begin()){
+            auto prev = std::prev(it);
+            if (store[prev->second].objectives[1] > p.objectives[1] + PARETO_EPS)
+                break;
+            kill(prev->second);
+            sorted.erase(prev);
+        }
+        return;
+    }
+
+    // Sous-arbres dont le min est sous p partout
+    vector<int> stack;
+    if (!nodes.empty())
+        stack.push_back(0);
+    while (!stack.empty()){
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+        bool below = true;
+        for (int k = 0; k < dim && below; k++)
+            below = node.low[k] <= p.objectives[k] + PARETO_EPS;
+        if (!below)
+            continue;
+        if (node.child[0] >= 0){
+            stack.push_back(node.child[0]);
+            stack.push_back(node.child[1]);
+            continue;
+        }
+        for (int id : node.ids){
+            if (alive[id] && dominates(p, store[id], dim))
+                kill(id);
+        }
+    }
+}
+
+
+void Pareto_Archive::index(int id)
+{
+    const Pareto_Point& p = store[id];
+    if (!p.x.empty())
+        by_allocation[allocation_hash(p.x)].push_back(id);
+    if (dim == 2)
+        sorted[p.objectives[0]] = id;
+    else
+        tree_insert(id);
+}
+
+
+void Pareto_Archive::tree_insert(int id)
+{
+    const auto& v = store[id].objectives;
+    if (nodes.empty()){
+        nodes.emplace_back();
+        nodes[0].low = nodes[0].high = v;
+    }
+    int cur = 0;
+    while (true){
+        Node& node = nodes[cur];
+        for (int k = 0; k < dim; k++){
+            node.low[k] = min(node.low[k], v[k]);
+            node.high[k] = max(node.high[k], v[k]);
+        }
+        if (node.child[0] < 0)
+            break;
+        cur = node.child[v[node.axis] >= node.split];
+    }
+    nodes[cur].ids.push_back(id);
+    if ((int) nodes[cur].ids.size() > LEAF_SIZE)
+        split_leaf(cur);
+}
+
+
+void Pareto_Archive::split_leaf(int leaf)
+{
+    vector<int> ids;
+    for (int id : nodes[leaf].ids){
+        if (alive[id])
+            ids.push_back(id);
+    }
+    nodes[leaf].ids = ids;
+    if ((int) ids.size() <= LEAF_SIZE)
+        return;
+
+    // Objectif le plus étendu, coupé à la médiane
+    int axis = 0;
+    double spread = -1;
+    for (int k = 0; k < dim; k++){
+        double lo = HUGE_VAL, hi = -HUGE_VAL;
+        for (int id : ids){
+            lo = min(lo, store[id].objectives[k]);
+            hi = max(hi, store[id].objectives[k]);
+        }
+        if (hi - lo > spread){
+            spread = hi - lo;
+            axis = k;
+        }
+    }
+    nth_element(ids.begin(), ids.begin() + ids.size() / 2, ids.end(),
+                [&](int a, int b){ return store[a].objectives[axis] < store[b].objectives[axis]; });
+    double split = store[ids[ids.size() / 2]].objectives[axis];
+
+    Node side[2];
+    for (int id : ids)
+        side[store[id].objectives[axis] >= split].ids.push_back(id);
+    if (side[0].ids.empty() || side[1].ids.empty())
+        return;     // valeurs égales sur l'axe : feuille gardée telle quelle
+    for (Node& s : side){
+        s.low = s.high = store[s.ids[0]].objectives;
+        for (int id : s.ids){
+            for (int k = 0; k < dim; k++){
+                s.low[k] = min(s.low[k], store[id].objectives[k]);
+                s.high[k] = max(s.high[k], store[id].objectives[k]);
+            }
+        }
+    }
+
+    int first = (int) nodes.size();
+    nodes.push_back(move(side[0]));
+    nodes.push_back(move(side[1]));
+    Node& node = nodes[leaf];
+    node.ids.clear();
+    node.ids.shrink_to_fit();
+    node.axis = axis;
+    node.split = split;
+    node.child[0] = first;
+    node.child[1] = first + 1;
+}
+
+
+// Compacte le stockage et reconstruit les index sur les points vivants
+void Pareto_Archive::rebuild()
+{
+    vector<Pareto_Point> kept;
+    kept.reserve(nb_alive);
+    for (size_t id = 0; id < store.size(); id++){
+        if (alive[id])
+            kept.push_back(move(store[id]));
+    }
+    store = move(kept);
+    alive.assign(store.size(), 1);
+    sorted.clear();
+    nodes.clear();
+    by_allocation.clear();
+    for (int id = 0; id < (int) store.size(); id++)
+        index(id);
+}
+
+
+bool Pareto_Archive::insert(const Pareto_Point& p)
+{
+    lock_guard<std::mutex> lock(mutex);
+    if (covered_locked(p))
+        return false;
+    remove_dominated(p);
+    store.push_back(p);
+    alive.push_back(1);
+    nb_alive++;
+    index((int) store.size() - 1);
+    if (store.size() > 2 * nb_alive + 64)
+        rebuild();
+    return true;
+}
+
+
+bool Pareto_Archive::covered(const Pareto_Point& p) const
+{
+    lock_guard<std::mutex> lock(mutex);
+    return covered_locked(p);
+}
+
+
+vector<Pareto_Point> Pareto_Archive::points() const
+{
+    vector<Pareto_Point> res;
+    {
+        lock_guard<std::mutex> lock(mutex);
+        res.reserve(nb_alive);
+        for (size_t id = 0; id < store.size(); id++){
+            if (alive[id])
+                res.push_back(store[id]);
+        }
+    }
+    sort(res.begin(), res.end(), [](const Pareto_Point& a, const Pareto_Point& b){
+        return a.objectives < b.objectives;
+    });
+    return res;
+}
+
+
+size_t Pareto_Archive::size() const
+{
+    lock_guard<std::mutex> lock(mutex);
+    return nb_alive;
+}
+
+
+void Pareto_Archive::save(const string& path) const
+{
+    vector<Pareto_Point> front = points();
+    size_t nb_words = front.empty() ? 0 : front[0].x.size();
+
+    ofstream out(path, ios::trunc);
+    if (!out){
+        throw runtime_error("Impossible d'ecrire " + path);
+    }
+    out << "pareto " << dim << " " << 64 * nb_words << " " << front.size() << "\n";
+    out << setprecision(17);
+    for (const auto& p : front){
+        for (int k = 0; k < dim; k++)
+            out << p.objectives[k] << " ";
+        out << hex << setfill('0');
+        for (size_t w = 0; w < nb_words; w++)
+            out << setw(16) << (w < p.x.size() ? p.x[w] : 0);
+        out << dec << setfill(' ') << "\n";
+    }
+    if (!out){
+        throw runtime_error("Impossible d'ecrire " + path);
+    }
+}
+
+
+void Pareto_Archive::load(const string& path)
+{
+    ifstream in(path);
+    if (!in){
+        throw runtime_error("Impossible d'ouvrir " + path);
+    }
+    string magic;
+    int nb_objectives;
+    size_t nb_bits, nb_points;
+    if (!(in >> magic >> nb_objectives >> nb_bits >> nb_points) || magic != "pareto" || nb_objectives != dim){
+        throw runtime_error(path + " : archive de Pareto invalide");
+    }
+    size_t nb_words = (nb_bits + 63) / 64;
+    for (size_t k = 0; k < nb_points; k++){
+        Pareto_Point p;
+        for (int o = 0; o < dim; o++)
+            in >> p.objectives[o];
+        string bits;
+        if (nb_words > 0)
+            in >> bits;
+        if (!in || bits.size() != 16 * nb_words){
+            throw runtime_error(path + " : point " + to_string(k) + " illisible");
+        }
+        p.x.resize(nb_words);
+        for (size_t w = 0; w < nb_words; w++)
+            p.x[w] = stoull(bits.substr(16 * w, 16), nullptr, 16);
+        insert(p);
+    }
+}
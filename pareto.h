@@ -0,0 +1,119 @@
+/*
+ Archive des points de Pareto, partagée entre threads.
+
+ Chaque point garde ses valeurs d'objectifs (2 à 4 : revenu TV, GRP, écart
+ prime, priorité), toutes maximisées (un objectif à minimiser est stocké
+ avec son opposé), et l'allocation qui l'atteint sous forme de bitmap
+ (bit i * n + j = x_ij). Un point n'est ajouté que s'il n'est ni un doublon
+ (même allocation, ou mêmes valeurs à PARETO_EPS près) ni dominé ; les
+ points qu'il domine sont retirés.
+
+ Index de dominance :
+  - 2 objectifs : trié par premier objectif croissant, le front l'est par
+    second décroissant. Le seul point qui peut dominer p est le premier de
+    premier objectif >= p, et les points dominés par p sont contigus juste
+    avant lui : test en O(log n), retrait en O(log n + points retirés).
+  - 3 ou 4 objectifs : arbre de boîtes (ND-tree). Chaque noeud connaît le
+    min et le max de ses points sur chaque objectif, ce qui écarte les
+    sous-arbres qui ne peuvent ni dominer p ni être dominés par lui. Les
+    feuilles sont coupées à la médiane de l'objectif le plus étendu :
+    O(log n) en pratique sur un front réparti, sans garantie dans le pire
+    cas (aucune structure ne l'a en dimension >= 3).
+ Les points retirés sont marqués puis l'index est reconstruit quand ils
+ deviennent majoritaires.
+
+ Toutes les opérations sont protégées par un mutex : les résolutions
+ parallèles des intervalles d'epsilon y écrivent directement.
+ */
+
+#ifndef PARETO_H
+#define PARETO_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Tolérance des comparaisons d'objectifs (valeurs lues dans CPLEX)
+const double PARETO_EPS = 1e-6;
+
+const int PARETO_MAX_OBJECTIVES = 4;
+
+struct Pareto_Point {
+    std::array<double, PARETO_MAX_OBJECTIVES> objectives{};    // maximisés
+    std::vector<uint64_t> x;                                    // bitmap des x_ij (vide = inconnue)
+
+    double revenue() const { return objectives[0]; }
+    double grp() const { return objectives[1]; }
+
+    bool assigned(size_t bit) const { return (x[bit / 64] >> (bit % 64)) & 1; }
+};
+
+// Bitmap des nb_bits premières valeurs (> 0.5 = 1)
+std::vector<uint64_t> pack_allocation(const std::vector<double>& values, size_t nb_bits);
+
+// a domine b sur les nb_objectives premiers objectifs : au moins aussi bon
+// partout, meilleur sur un
+bool dominates(const Pareto_Point& a, const Pareto_Point& b, int nb_objectives = 2);
+
+class Pareto_Archive {
+public:
+    explicit Pareto_Archive(int nb_objectives = 2);
+
+    Pareto_Archive(const Pareto_Archive&) = delete;
+    Pareto_Archive& operator=(const Pareto_Archive&) = delete;
+
+    int nb_objectives() const { return dim; }
+
+    // Renvoie false si p est un doublon ou dominé
+    bool insert(const Pareto_Point& p);
+
+    // p serait-il rejeté (doublon ou dominé) ?
+    bool covered(const Pareto_Point& p) const;
+
+    // Points non dominés, par premier objectif croissant
+    std::vector<Pareto_Point> points() const;
+
+    size_t size() const;
+
+    // Fichier texte : "pareto <objectifs> <bits> <points>" puis une ligne
+    // par point, valeurs puis bitmap en mots hexadécimaux de 64 bits.
+    // load ajoute les points du fichier (dominance comprise).
+    // Lèvent std::runtime_error si le fichier est illisible.
+    void save(const std::string& path) const;
+    void load(const std::string& path);
+
+private:
+    static const int LEAF_SIZE = 16;
+
+    struct Node {
+        std::array<double, PARETO_MAX_OBJECTIVES> low, high;   // boîte des points du sous-arbre
+        int child[2] = { -1, -1 };                              // -1 : feuille
+        int axis = 0;
+        double split = 0;
+        std::vector<int> ids;
+    };
+
+    int dim;
+    mutable std::mutex mutex;
+    std::vector<Pareto_Point> store;
+    std::vector<char> alive;
+    size_t nb_alive = 0;
+
+    std::map<double, int> sorted;                               // 2 objectifs
+    std::vector<Node> nodes;                                    // 3 ou 4 objectifs, racine 0
+    std::unordered_map<uint64_t, std::vector<int>> by_allocation;
+
+    bool covered_locked(const Pareto_Point& p) const;
+    bool same_allocation_locked(const Pareto_Point& p, uint64_t h) const;
+    void remove_dominated(const Pareto_Point& p);
+    void index(int id);
+    void tree_insert(int id);
+    void split_leaf(int node);
+    void rebuild();
+};
+
+#endif
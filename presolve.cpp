@@ -0,0 +1,329 @@
+/*
+ Presolve : élimination des couples impossibles et des contraintes redondantes.
+ */
+
+#include "presolve.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <unordered_map>
+
+using namespace std;
+
+
+namespace {
+
+const double FIT_EPS = 1e-6;
+
+// FNV-1a sur les données d'un écran qui comptent pour le modèle
+struct Break_Hash {
+    uint64_t h = 1469598103934665603ull;
+
+    template <class T> void add(const T& v)
+    {
+        unsigned char bytes[sizeof(T)];
+        memcpy(bytes, &v, sizeof(T));
+        for (unsigned char b : bytes){
+            h ^= b;
+            h *= 1099511628211ull;
+        }
+    }
+};
+
+uint64_t break_hash(const Instance& inst, int i)
+{
+    Break_Hash h;
+    h.add(inst.station[i]);
+    h.add(inst.prime_break[i]);
+    h.add(inst.break_time[i]);
+    for (int s = 0; s < NB_SLOTS; s++){
+        h.add(inst.slot_price[s][i]);
+        h.add(inst.slot_available[s][i]);
+    }
+    for (int a = 0; a < inst.nb_Audiences(); a++)
+        h.add(inst.grp[a][i]);
+    return h.h;
+}
+
+bool same_break(const Instance& inst, int i1, int i2)
+{
+    if (inst.station[i1] != inst.station[i2] || inst.prime_break[i1] != inst.prime_break[i2]
+        || inst.break_time[i1] != inst.break_time[i2])
+        return false;
+    for (int s = 0; s < NB_SLOTS; s++){
+        if (inst.slot_price[s][i1] != inst.slot_price[s][i2] || inst.slot_available[s][i1] != inst.slot_available[s][i2])
+            return false;
+    }
+    for (int a = 0; a < inst.nb_Audiences(); a++){
+        if (inst.grp[a][i1] != inst.grp[a][i2])
+            return false;
+    }
+    return true;
+}
+
+}
+
+
+int Presolve::var_index(int r, int j) const
+{
+    auto first = var_brand.begin() + row_vars[r], last = var_brand.begin() + row_vars[r + 1];
+    auto it = lower_bound(first, last, j);
+    return it != last && *it == j ? (int) (it - var_brand.begin()) : -1;
+}
+
+
+Presolve presolve(const Instance& inst, const Options& opt)
+{
+    auto t0 = chrono::steady_clock::now();
+    int m = inst.nb_Com_Break, n = inst.nb_Brands;
+    bool reduce = opt.presolve;
+    Presolve pre;
+    Presolve_Stats& stats = pre.stats;
+
+    // Lignes : un écran, ou ses positions disponibles
+    pre.break_rows.assign(1, 0);
+    for (int i = 0; i < m; i++){
+        for (int s = 0; s < NB_SLOTS; s++){
+            if (!opt.slots && s > 0)
+                break;
+            if (opt.slots && !inst.slot_available[s][i])
+                continue;
+            pre.row_break.push_back(i);
+            pre.row_slot.push_back(opt.slots ? s : -1);
+        }
+        pre.break_rows.push_back(pre.nb_rows());
+    }
+
+    // Couples candidats
+    pre.row_vars.assign(1, 0);
+    for (int r = 0; r < pre.nb_rows(); r++){
+        int i = pre.row_break[r];
+        float price = opt.slots ? inst.slot_cost(i, pre.row_slot[r]) : inst.cost(i, 0);
+        for (int j = 0; j < n; j++){
+            double spend = price * inst.brand_time[j];
+            if (reduce && inst.brand_time[j] > inst.break_time[i] + FIT_EPS){
+                stats.too_long++;
+                continue;
+            }
+            if (reduce && spend > inst.budget_cap[j] + FIT_EPS){
+                stats.over_budget++;
+                continue;
+            }
+            pre.var_row.push_back(r);
+            pre.var_brand.push_back(j);
+            pre.var_spend.push_back(spend);
+        }
+        pre.row_vars.push_back(pre.nb_vars());
+    }
+    stats.nb_pairs = (long long) pre.nb_rows() * n;
+
+    // Dépense maximale de chaque marque (au plus une fois par écran) et
+    // durée maximale de chaque écran (au plus une marque par type)
+    vector<double> spend_bound(n, 0), time_bound(m, 0);
+    vector<double> best_spend(n), best_time(inst.nb_Types());
+    vector<int> nb_brand_vars(n, 0), nb_break_vars(m, 0);
+    for (int i = 0; i < m; i++){
+        fill(best_spend.begin(), best_spend.end(), 0.0);
+        fill(best_time.begin(), best_time.end(), 0.0);
+        for (int k = pre.row_vars[pre.break_rows[i]]; k < pre.row_vars[pre.break_rows[i + 1]]; k++){
+            int j = pre.var_brand[k];
+            best_spend[j] = max(best_spend[j], pre.var_spend[k]);
+            best_time[inst.brand_type[j]] = max(best_time[inst.brand_type[j]], (double) inst.brand_time[j]);
+            nb_brand_vars[j]++;
+            nb_break_vars[i]++;
+        }
+        for (int j = 0; j < n; j++)
+            spend_bound[j] += best_spend[j];
+        for (double t : best_time)
+            time_bound[i] += t;
+    }
+
+    // Contraintes de budget et de durée : gardées si la borne peut les violer
+    pre.max_spend.resize(n);
+    pre.budget_row.assign(n, 1);
+    pre.time_row.assign(m, 1);
+    for (int j = 0; j < n; j++){
+        pre.max_spend[j] = reduce ? min(spend_bound[j], (double) inst.budget_cap[j]) : inst.budget_cap[j];
+        if (reduce)
+            pre.budget_row[j] = nb_brand_vars[j] > 0 && spend_bound[j] > inst.budget_cap[j] + FIT_EPS;
+        stats.budget_rows[1] += pre.budget_row[j];
+    }
+    for (int i = 0; i < m; i++){
+        if (reduce)
+            pre.time_row[i] = nb_break_vars[i] > 0 && time_bound[i] > inst.break_time[i] + FIT_EPS;
+        stats.time_rows[1] += pre.time_row[i];
+    }
+    stats.budget_rows[0] = n;
+    stats.time_rows[0] = m;
+
+    // Classes d'écrans interchangeables, détectées par hachage : seules
+    // celles sans contrainte de durée sont agrégées (leurs comptes se
+    // répartissent alors toujours sur les écrans, voir expand_allocation).
+    // Les lignes des autres écrans de la classe disparaissent, celle du
+    // représentant compte pour toute la classe.
+    pre.break_rep.resize(m);
+    iota(pre.break_rep.begin(), pre.break_rep.end(), 0);
+    pre.row_count.assign(pre.nb_rows(), 1);
+    if (reduce && opt.aggregate){
+        unordered_map<uint64_t, vector<int>> classes;
+        for (int i = 0; i < m; i++){
+            if (pre.time_row[i] || nb_break_vars[i] == 0)
+                continue;
+            vector<int>& reps = classes[break_hash(inst, i)];
+            auto it = find_if(reps.begin(), reps.end(), [&](int c){ return same_break(inst, c, i); });
+            if (it == reps.end())
+                reps.push_back(i);
+            else
+                pre.break_rep[i] = *it;
+        }
+        vector<int> class_size(m, 0);
+        for (int i = 0; i < m; i++)
+            class_size[pre.break_rep[i]]++;
+
+        Presolve kept;
+        kept.break_rows.assign(1, 0);
+        kept.row_vars.assign(1, 0);
+        for (int i = 0; i < m; i++){
+            if (pre.break_rep[i] == i){
+                stats.nb_classes += class_size[i] > 1;
+                for (int r = pre.break_rows[i]; r < pre.break_rows[i + 1]; r++){
+                    for (int k = pre.row_vars[r]; k < pre.row_vars[r + 1]; k++){
+                        kept.var_row.push_back(kept.nb_rows());
+                        kept.var_brand.push_back(pre.var_brand[k]);
+                        kept.var_spend.push_back(pre.var_spend[k]);
+                    }
+                    kept.row_break.push_back(i);
+                    kept.row_slot.push_back(pre.row_slot[r]);
+                    kept.row_count.push_back(class_size[i]);
+                    kept.row_vars.push_back(kept.nb_vars());
+                }
+            }
+            else {
+                stats.nb_aggregated++;
+            }
+            kept.break_rows.push_back(kept.nb_rows());
+        }
+        pre.row_break = move(kept.row_break);
+        pre.row_slot = move(kept.row_slot);
+        pre.break_rows = move(kept.break_rows);
+        pre.row_count = move(kept.row_count);
+        pre.var_row = move(kept.var_row);
+        pre.var_brand = move(kept.var_brand);
+        pre.var_spend = move(kept.var_spend);
+        pre.row_vars = move(kept.row_vars);
+    }
+
+    // Exclusions : marques concurrentes (une contrainte par écran et par
+    // type, ou par paire avec opt.quadratic_competitors), et avec les
+    // positions, une marque par position et une position par marque
+    pre.clique_start.assign(1, 0);
+    vector<char> in_clique(pre.nb_vars(), 0);
+    auto add_clique = [&](const vector<int>& vars, int nb_before){
+        stats.clique_rows[0] += nb_before >= 2;
+        if (vars.size() < 2 && (reduce || vars.empty()))
+            return;
+        for (int k : vars){
+            pre.clique_vars.push_back(k);
+            in_clique[k] = 1;
+        }
+        pre.clique_start.push_back((int) pre.clique_vars.size());
+        pre.clique_rhs.push_back(pre.row_count[pre.var_row[vars[0]]]);
+        stats.clique_rows[1]++;
+    };
+    vector<int> vars;
+    vector<vector<int>> by_type(inst.nb_Types());
+    for (int i = 0; i < m; i++){
+        // un écran agrégé avait sa ligne avant le presolve
+        int nb_rows_i = pre.break_rep[i] != i ? 1 : pre.break_rows[i + 1] - pre.break_rows[i];
+        for (auto& v : by_type)
+            v.clear();
+        for (int k = pre.row_vars[pre.break_rows[i]]; k < pre.row_vars[pre.break_rows[i + 1]]; k++)
+            by_type[inst.brand_type[pre.var_brand[k]]].push_back(k);
+
+        if (opt.quadratic_competitors){
+            for (int t = 0; t < inst.nb_Types(); t++)
+                stats.clique_rows[0] += inst.type_size(t) * (inst.type_size(t) - 1) / 2;
+            for (const auto& v : by_type){
+                for (size_t a = 0; a < v.size(); a++){
+                    for (size_t b = a + 1; b < v.size(); b++)
+                        add_clique({ v[a], v[b] }, 0);
+                }
+            }
+            continue;
+        }
+        for (int t = 0; t < inst.nb_Types(); t++){
+            int nb_before = nb_rows_i * inst.type_size(t);
+            if (inst.type_size(t) < 2 && !opt.slots)
+                continue;
+            add_clique(by_type[t], nb_before);
+        }
+    }
+    if (opt.slots){
+        for (int r = 0; r < pre.nb_rows(); r++){
+            vars.clear();
+            for (int k = pre.row_vars[r]; k < pre.row_vars[r + 1]; k++)
+                vars.push_back(k);
+            add_clique(vars, n);
+        }
+    }
+
+    // Candidats libres de toute contrainte : fixés à 1 (2 objectifs croissants)
+    pre.fixed.assign(pre.nb_vars(), 0);
+    if (reduce && opt.objectives == 2){
+        for (int k = 0; k < pre.nb_vars(); k++){
+            int i = pre.row_break[pre.var_row[k]], j = pre.var_brand[k];
+            if (!pre.budget_row[j] && !pre.time_row[i] && !in_clique[k]){
+                pre.fixed[k] = 1;
+                stats.nb_fixed++;
+            }
+        }
+    }
+
+    stats.time = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    return pre;
+}
+
+
+void print_presolve_stats(const Presolve_Stats& stats)
+{
+    long long removed = stats.too_long + stats.over_budget;
+    cout << "Presolve : " << removed << " / " << stats.nb_pairs << " couples elimines ("
+         << stats.too_long << " trop longs, " << stats.over_budget << " hors budget), "
+         << stats.nb_fixed << " fixes a 1 ; contraintes budget " << stats.budget_rows[0] << " -> "
+         << stats.budget_rows[1] << ", duree " << stats.time_rows[0] << " -> " << stats.time_rows[1]
+         << ", exclusions " << stats.clique_rows[0] << " -> " << stats.clique_rows[1];
+    if (stats.nb_classes > 0)
+        cout << " ; " << stats.nb_aggregated << " ecrans agreges en " << stats.nb_classes << " classes";
+    cout << " (" << stats.time * 1000 << " ms)" << endl;
+}
+
+
+vector<double> expand_allocation(const Instance& inst, const Presolve& pre, const vector<double>& values)
+{
+    int m = inst.nb_Com_Break, n = inst.nb_Brands;
+    vector<double> x((size_t) m * n, 0);
+    if (values.empty())
+        return x;
+
+    // Ecrans de chaque classe, représentant en premier
+    vector<vector<int>> members(m);
+    for (int i = 0; i < m; i++)
+        members[pre.break_rep[i]].push_back(i);
+
+    vector<int> next(inst.nb_Types());
+    for (int r = 0; r < pre.nb_rows(); r++){
+        const vector<int>& breaks = members[pre.row_break[r]];
+        fill(next.begin(), next.end(), 0);
+        for (int k = pre.row_vars[r]; k < pre.row_vars[r + 1]; k++){
+            int j = pre.var_brand[k];
+            int& pos = next[inst.brand_type[j]];
+            for (int u = (int) floor(values[k] + 0.5); u > 0 && pos < (int) breaks.size(); u--)
+                x[(size_t) breaks[pos++] * n + j] = 1;
+        }
+    }
+    return x;
+}
@@ -0,0 +1,104 @@
+/*
+ Presolve du modèle exact : liste creuse des couples (ligne, marque) candidats.
+
+ Une ligne est un écran, ou avec opt.slots une position disponible de
+ l'écran. Avant la construction du modèle :
+    - les couples impossibles sont éliminés : format plus long que l'écran
+      (t_j > T_i), ou spot seul plus cher que le budget de la marque ;
+    - chaque contrainte reçoit la borne de son activité maximale sur les
+      candidats restants (une marque au plus une fois par écran, une marque
+      au plus par type). Une contrainte de budget ou de durée que cette
+      borne respecte déjà est redondante et n'est pas créée ; la dépense
+      maximale de chaque marque borne aussi la variable d'écart prime d_j ;
+    - les exclusions (marques concurrentes, position occupée) à moins de
+      deux candidats disparaissent ;
+    - avec 2 objectifs, qui croissent tous deux avec chaque x, un candidat
+      qui n'apparaît plus dans aucune contrainte est fixé à sa borne : toute
+      solution qui le laisse plus bas est dominée ;
+    - avec opt.aggregate (sans opt.slots), les écrans interchangeables pour
+      le modèle (même station, prime, durée, prix des positions et GRP par
+      audience), regroupés par hachage, ne forment plus qu'une ligne : ses
+      variables sont des comptes entiers 0 .. taille de la classe, et ses
+      exclusions bornent la somme par cette taille. Seules les classes sans
+      contrainte de durée (redondante) sont agrégées : des comptes qui
+      respectent les exclusions se répartissent alors toujours sur les
+      écrans de la classe (expand_allocation). Une classe de c écrans
+      remplace c! solutions symétriques par une seule.
+ Les marques identiques ne sont pas agrégées : chacune a son propre budget,
+ et répartir un compte entre elles serait un problème de bin packing.
+ Sans opt.presolve, tous les couples et toutes les contraintes sont gardés
+ (modèle d'origine).
+ */
+
+#ifndef PRESOLVE_H
+#define PRESOLVE_H
+
+#include <vector>
+#include "instance.h"
+#include "options.h"
+
+struct Presolve_Stats {
+    long long nb_pairs = 0;         // couples (ligne, marque) avant presolve
+    long long too_long = 0;         // t_j > T_i
+    long long over_budget = 0;      // spot seul au-delà de BUDGET_j
+    long long nb_fixed = 0;         // candidats fixés à leur borne
+    int nb_classes = 0;             // classes d'écrans agrégées
+    int nb_aggregated = 0;          // écrans absorbés par leur représentant
+    int budget_rows[2] = { 0, 0 };  // contraintes avant / après
+    int time_rows[2] = { 0, 0 };
+    int clique_rows[2] = { 0, 0 };
+    double time = 0;                // secondes
+};
+
+struct Presolve {
+    // Lignes : écran i, et position (-1 sans opt.slots) ; celles de
+    // l'écran i sont break_rows[i] .. break_rows[i + 1] - 1
+    std::vector<int> row_break;
+    std::vector<int> row_slot;
+    std::vector<int> break_rows;
+
+    // Agrégation : écrans représentés par la ligne r (1 sans agrégation),
+    // et représentant de chaque écran (lui-même s'il n'est pas agrégé ; un
+    // écran agrégé n'a aucune ligne)
+    std::vector<int> row_count;
+    std::vector<int> break_rep;
+
+    // Candidats, variables du modèle dans cet ordre : par ligne puis par
+    // marque croissante ; ceux de la ligne r sont row_vars[r] .. row_vars[r + 1] - 1
+    std::vector<int> var_row;
+    std::vector<int> var_brand;
+    std::vector<double> var_spend;      // prix de la ligne * t_j
+    std::vector<int> row_vars;
+    std::vector<char> fixed;            // fixé à row_count de sa ligne
+
+    // Contraintes à créer
+    std::vector<char> budget_row;       // par marque
+    std::vector<char> time_row;         // par écran
+    std::vector<int> clique_start;      // au plus clique_rhs[c] candidats
+    std::vector<int> clique_vars;       // de clique_vars[clique_start[c] ..]
+    std::vector<int> clique_rhs;
+    std::vector<double> max_spend;      // dépense maximale de chaque marque
+
+    Presolve_Stats stats;
+
+    int nb_rows() const { return (int) row_break.size(); }
+    int nb_vars() const { return (int) var_row.size(); }
+    int nb_cliques() const { return (int) clique_start.size() - 1; }
+
+    // Variable du couple (r, j), -1 si le couple a été éliminé
+    int var_index(int r, int j) const;
+};
+
+Presolve presolve(const Instance& inst, const Options& opt);
+
+// x_ij par écran (x[i * nb_Brands + j]) d'une solution sur les candidats :
+// une position occupée compte pour son écran, et le compte w d'une classe
+// est réparti sur ses écrans type par type, les marques d'un type occupant
+// des écrans successifs (la somme du type est au plus la taille de la
+// classe, et la durée ne contraint pas la classe)
+std::vector<double> expand_allocation(const Instance& inst, const Presolve& pre, const std::vector<double>& values);
+
+// Une ligne de statistiques
+void print_presolve_stats(const Presolve_Stats& stats);
+
+#endif
@@ -0,0 +1,181 @@
+/*
+ Horizon glissant : fenêtres successives, budgets reportés.
+ */
+
+#include "rolling.h"
+#include "model.h"
+#include "presolve.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+using namespace std;
+
+
+namespace {
+
+const double BUDGET_EPS = 1e-6;
+const double SECONDS_PER_DAY = 86400;
+
+}
+
+
+Rolling_Result rolling_horizon(const Instance& inst, const Options& opt, Objective objective,
+                               const Allocation& start)
+{
+    auto t0 = chrono::steady_clock::now();
+    int m = inst.nb_Com_Break, n = inst.nb_Brands;
+    bool by_grp = objective == Objective::GRP;
+
+    auto price = [&](int i, int j){ return (double) (inst.cost(i, j) * inst.brand_time[j]); };
+    auto value = [&](int i, int j){ return by_grp ? (double) inst.grp_of(i, j) : price(i, j); };
+
+    Rolling_Result result;
+    Allocation& alloc = result.allocation;
+    alloc.x.assign((size_t) m * n, 0);
+
+    vector<int> order(m);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](int a, int b){
+        return inst.start_date[a] < inst.start_date[b];
+    });
+
+    int64_t length = (int64_t) (opt.window * SECONDS_PER_DAY);
+    int64_t shift = (int64_t) ((opt.window - opt.overlap) * SECONDS_PER_DAY);
+    if (shift < 1){
+        // la boucle n'avancerait jamais
+        throw runtime_error("Horizon glissant : decalage des fenetres inferieur a une seconde");
+    }
+
+    Options sub_opt = opt;
+    sub_opt.parallel = 0;
+    sub_opt.objectives = 2;
+
+    // Budget restant après les écrans figés, et décisions reportées du
+    // recouvrement (x[i * n + j])
+    vector<double> remaining(n);
+    for (int j = 0; j < n; j++){
+        remaining[j] = inst.budget_cap[j];
+    }
+    vector<uint8_t> carried((size_t) m * n, 0);
+
+    int first = 0;      // premier écran non figé dans order
+    while (first < m){
+        int64_t a = inst.start_date[order[first]];
+        int end = first;
+        while (end < m && inst.start_date[order[end]] < a + length)
+            end++;
+        // La dernière fenêtre fige tout ; le premier écran est toujours figé
+        // (shift > 0)
+        bool last = end == m;
+        int frozen = first;
+        while (frozen < end && (last || inst.start_date[order[frozen]] < a + shift))
+            frozen++;
+
+        vector<int> breaks(order.begin() + first, order.begin() + end);
+        Instance sub = inst.select_breaks(breaks);
+        int ms = sub.nb_Com_Break;
+
+        // Budget de la fenêtre : le reste, au prorata de sa part de la
+        // demande restante (tout le reste pour la dernière)
+        vector<double> budget = remaining;
+        if (!last){
+            vector<double> demand(n, 0), rest(n, 0);
+            for (int k = first; k < m; k++){
+                int i = order[k];
+                for (int j = 0; j < n; j++){
+                    if (inst.brand_time[j] <= inst.break_time[i]){
+                        rest[j] += price(i, j);
+                        if (k < end)
+                            demand[j] += price(i, j);
+                    }
+                }
+            }
+            for (int j = 0; j < n; j++){
+                if (rest[j] > 0)
+                    budget[j] = floor(remaining[j] * demand[j] / rest[j]);
+            }
+        }
+        // Arrondi vers le bas : la fenêtre ne dépense jamais plus que le reste
+        for (int j = 0; j < n; j++){
+            budget[j] = sub.set_budget(j, budget[j]);
+        }
+
+        // Départ : décisions reportées, puis allocation gloutonne tant que
+        // le budget restant le permet
+        vector<double> x((size_t) ms * n, 0);
+        vector<double> left = budget;
+        double start_value = 0;
+        for (int pass = 0; pass < 2; pass++){
+            const vector<uint8_t>& from = pass == 0 ? carried : start.x;
+            for (int k = 0; k < ms; k++){
+                int i = breaks[k];
+                bool is_carried = false;
+                for (int j = 0; j < n; j++)
+                    is_carried |= carried[(size_t) i * n + j] != 0;
+                if (pass == 1 && is_carried)
+                    continue;
+                for (int j = 0; j < n; j++){
+                    if (from[(size_t) i * n + j] && price(i, j) <= left[j] + BUDGET_EPS){
+                        x[(size_t) k * n + j] = 1;
+                        left[j] -= price(i, j);
+                        start_value += value(i, j);
+                    }
+                }
+            }
+        }
+
+        Presolve pre = presolve(sub, sub_opt);
+        Solve_Status status = Solve_Status::OPTIMAL;
+        if (pre.nb_vars() > 0){
+            Allocation_Model model(sub, sub_opt, pre);
+            model.quiet();
+            if (by_grp)
+                model.maximize_grp();
+            else
+                model.maximize_revenue();
+            if (opt.warm_start)
+                model.add_start(model.to_model_values(x), true);
+
+            // Le départ est réalisable : une solution moins bonne (départ
+            // ignoré par le solveur natif) n'est pas gardée
+            if (model.solve() && (by_grp ? model.grp_value() : model.revenue_value()) >= start_value - BUDGET_EPS)
+                x = model.allocation_values();
+            status = model.status();
+        }
+        else {
+            fill(x.begin(), x.end(), 0);
+        }
+        result.nb_optimal += status == Solve_Status::OPTIMAL;
+
+        // Écrans figés : dépense retirée des budgets ; recouvrement reporté
+        for (int k = 0; k < ms; k++){
+            int i = breaks[k];
+            for (int j = 0; j < n; j++){
+                size_t ij = (size_t) i * n + j;
+                bool chosen = x[(size_t) k * n + j] > 0.5;
+                carried[ij] = 0;
+                if (k >= frozen - first){
+                    carried[ij] = chosen;
+                }
+                else if (chosen){
+                    alloc.x[ij] = 1;
+                    alloc.revenue += price(i, j);
+                    alloc.grp += inst.grp_of(i, j);
+                    alloc.nb_spots++;
+                    remaining[j] -= price(i, j);
+                }
+            }
+        }
+
+        result.windows.push_back({ ms, frozen - first, status });
+        result.nb_windows++;
+        first = frozen;
+    }
+
+    result.time = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    return result;
+}
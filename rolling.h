@@ -0,0 +1,54 @@
+/*
+ Horizon glissant sur la date des écrans.
+
+ Sur une campagne longue, le modèle de toute la période est trop grand. Les
+ écrans sont triés par start_date et résolus par fenêtres successives de
+ opt.window jours, chacune décalée de opt.window - opt.overlap jours par
+ rapport à la précédente :
+    - la fenêtre [a, a + window[ contient les écrans non encore figés de
+      cette période ; son modèle exact (presolve compris) reçoit comme
+      budget de chaque marque ce qui reste après les écrans figés ;
+    - les décisions des écrans de [a, a + window - overlap[ sont alors
+      figées et leur dépense retirée des budgets ; celles du recouvrement
+      ne sont que reportées : la fenêtre suivante les reprend comme MIP
+      start (complété par l'allocation gloutonne tant que le budget
+      restant le permet) et peut les modifier ;
+    - la dernière fenêtre fige tout. Une période sans écran est sautée.
+ Chaque fenêtre a une taille bornée : le temps croît linéairement avec la
+ durée de la campagne. Un budget dépensé tôt n'est plus disponible pour la
+ fin de la campagne : pas de garantie d'optimalité globale.
+ */
+
+#ifndef ROLLING_H
+#define ROLLING_H
+
+#include "heuristic.h"
+#include "instance.h"
+#include "options.h"
+#include "solver.h"
+
+#include <vector>
+
+struct Window_Stats {
+    int nb_breaks = 0;          // écrans de la fenêtre
+    int nb_frozen = 0;          // écrans figés à l'issue de la fenêtre
+    Solve_Status status = Solve_Status::UNKNOWN;
+};
+
+struct Rolling_Result {
+    Allocation allocation;      // décisions figées de toutes les fenêtres
+    std::vector<Window_Stats> windows;  // une entrée par fenêtre résolue
+    int nb_windows = 0;
+    int nb_optimal = 0;         // fenêtres résolues à l'optimum
+    double time = 0;            // secondes
+};
+
+// Maximise l'objectif fenêtre par fenêtre (opt.time_limit et opt.threads
+// par fenêtre), sans rien afficher : l'appelant lit result.windows.
+// Lève std::runtime_error si le décalage window - overlap est inférieur à
+// une seconde. start : allocation réalisable de l'instance complète, dont
+// les décisions complètent les MIP starts.
+Rolling_Result rolling_horizon(const Instance& inst, const Options& opt, Objective objective,
+                               const Allocation& start);
+
+#endif
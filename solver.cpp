@@ -0,0 +1,43 @@
+/*
+ Choix du solveur.
+ */
+
+#include "solver.h"
+
+#include <stdexcept>
+#include "native_backend.h"
+#ifndef NO_CPLEX
+#include "cplex_backend.h"
+#endif
+
+using namespace std;
+
+
+const char* status_name(Solve_Status status)
+{
+    switch (status){
+        case Solve_Status::OPTIMAL:     return "Optimal";
+        case Solve_Status::FEASIBLE:    return "Feasible";
+        case Solve_Status::INFEASIBLE:  return "Infeasible";
+        case Solve_Status::UNBOUNDED:   return "Unbounded";
+        default:                        return "Unknown";
+    }
+}
+
+
+unique_ptr<Solver_Backend> make_backend(const Options& opt)
+{
+    if (opt.solver == "native"){
+        return unique_ptr<Solver_Backend>(new Native_Backend(opt));
+    }
+#ifndef NO_CPLEX
+    if (opt.solver == "cplex"){
+        return unique_ptr<Solver_Backend>(new Cplex_Backend(opt));
+    }
+#else
+    if (opt.solver == "cplex"){
+        throw runtime_error("Solveur cplex indisponible : programme compile avec NO_CPLEX");
+    }
+#endif
+    throw runtime_error("Solveur inconnu : " + opt.solver);
+}
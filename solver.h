@@ -0,0 +1,101 @@
+/*
+ Interface des solveurs du modèle d'allocation.
+
+ Le modèle utilise des variables binaires (et quelques variables continues
+ bornées), des lignes linéaires lb <= sum coef_k * x_k <= ub et un objectif
+ linéaire à maximiser. Les
+ variables peuvent aussi être ajoutées colonne par colonne dans des lignes
+ existantes, et la relaxation linéaire résolue avec ses valeurs duales
+ (génération de colonnes, voir colgen.h). Deux implémentations :
+    - "cplex"  : Concert / CPLEX (absente si compilé avec -DNO_CPLEX),
+    - "native" : branch-and-bound sur la relaxation linéaire, sans dépendance,
+                 pour les machines sans licence CPLEX.
+ */
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "options.h"
+
+enum class Solve_Status {
+    OPTIMAL,
+    FEASIBLE,       // solution réalisable, optimalité non prouvée (limite de temps)
+    INFEASIBLE,
+    UNBOUNDED,
+    UNKNOWN         // aucune solution trouvée dans la limite de temps
+};
+
+const char* status_name(Solve_Status status);
+
+class Solver_Backend {
+public:
+    virtual ~Solver_Backend() {}
+
+    virtual std::string name() const = 0;
+
+    // Ajoute n variables binaires, numérotées à la suite des précédentes
+    virtual void add_variables(int n) = 0;
+
+    // Ajoute n variables continues dans [0, ub] (variables auxiliaires des
+    // linéarisations), numérotées de même
+    virtual void add_continuous_variables(int n, double ub) = 0;
+
+    // Ajoute n variables entières dans [0, ub] (comptes des classes d'écrans
+    // agrégées), numérotées de même
+    virtual void add_integer_variables(int n, int ub) = 0;
+
+    // Ajoute lb <= sum coefs[k] * x[vars[k]] <= ub (bornes infinies : +-SOLVER_INFINITY).
+    // Renvoie le numéro de la ligne.
+    virtual int add_row(const std::vector<int>& vars, const std::vector<double>& coefs,
+                        double lb, double ub) = 0;
+    virtual void set_row_bounds(int row, double lb, double ub) = 0;
+
+    // Ajoute une variable binaire, de coefficient obj dans l'objectif et
+    // coefs[k] dans la ligne rows[k]. Renvoie le numéro de la variable.
+    virtual int add_column(double obj, const std::vector<int>& rows, const std::vector<double>& coefs) = 0;
+
+    // Objectif à maximiser, un coefficient par variable
+    virtual void set_objective(const std::vector<double>& coefs) = 0;
+
+    // Solution de départ (une valeur par variable). Une solution gardée sert
+    // pour toutes les résolutions suivantes ; sinon elle remplace la
+    // précédente solution non gardée.
+    virtual void add_start(const std::vector<double>& values, bool keep) = 0;
+
+    virtual Solve_Status solve() = 0;
+
+    // Relaxation linéaire (variables dans [0, 1]) : objective_value() et
+    // values() en donnent la solution, duals() la valeur duale de chaque
+    // ligne (dérivée de l'objectif par rapport à sa borne active, >= 0 pour
+    // une borne supérieure)
+    virtual Solve_Status solve_relaxation() = 0;
+    virtual std::vector<double> duals() const = 0;
+
+    // Solution de la dernière résolution
+    virtual double objective_value() const = 0;
+    virtual std::vector<double> values() const = 0;
+
+    // Temps avant la première solution réalisable de la dernière résolution
+    // (-1 si aucune, ou si elle n'a pas été observée : CPLEX ne la voit que
+    // pendant le branch-and-bound, pas quand le présolve résout le modèle)
+    virtual double first_incumbent_time() const = 0;
+
+    virtual int nb_variables() const = 0;
+    virtual int nb_rows() const = 0;
+
+    // Export au format LP
+    virtual void export_model(const std::string& path) = 0;
+
+    // Plus aucune sortie du solveur (résolutions en parallèle)
+    virtual void quiet() = 0;
+};
+
+const double SOLVER_INFINITY = 1e20;
+
+// Solveur choisi par opt.solver. Lève std::runtime_error si inconnu ou non compilé.
+std::unique_ptr<Solver_Backend> make_backend(const Options& opt);
+
+#endif
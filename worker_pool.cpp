@@ -0,0 +1,93 @@
+/*
+ Groupe de threads persistants : distribution des tâches et barrière de fin.
+ */
+
+#include "worker_pool.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+Worker_Pool::Worker_Pool(int nb_threads)
+{
+    if (nb_threads <= 0){
+        nb_threads = max(1u, thread::hardware_concurrency());
+    }
+    for (int t = 1; t < nb_threads; t++){
+        workers.emplace_back(&Worker_Pool::loop, this);
+    }
+}
+
+Worker_Pool::~Worker_Pool()
+{
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    start.notify_all();
+    for (auto& th : workers){
+        th.join();
+    }
+}
+
+void Worker_Pool::run(int nb_tasks, const function<void(int)>& task)
+{
+    {
+        lock_guard<std::mutex> lock(mutex);
+        this->task = &task;
+        this->nb_tasks = nb_tasks;
+        next = 0;
+        failed = false;
+        error = nullptr;
+        nb_busy = (int) workers.size();
+        generation++;
+    }
+    start.notify_all();
+    work();
+
+    unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&]{ return nb_busy == 0; });
+    this->task = nullptr;
+    if (error){
+        exception_ptr e = error;
+        error = nullptr;
+        rethrow_exception(e);
+    }
+}
+
+// Prend des tâches jusqu'à épuisement ou erreur
+void Worker_Pool::work()
+{
+    try {
+        int k;
+        while (!failed && (k = next++) < nb_tasks){
+            (*task)(k);
+        }
+    }
+    catch (...) {
+        lock_guard<std::mutex> lock(mutex);
+        failed = true;
+        if (!error)
+            error = current_exception();
+    }
+}
+
+// Boucle d'un thread du groupe : attend un tour, y participe, signale sa fin
+void Worker_Pool::loop()
+{
+    long seen = 0;
+    while (true){
+        {
+            unique_lock<std::mutex> lock(mutex);
+            start.wait(lock, [&]{ return stop || generation != seen; });
+            if (stop)
+                return;
+            seen = generation;
+        }
+        work();
+        lock_guard<std::mutex> lock(mutex);
+        if (--nb_busy == 0)
+            done.notify_one();
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ Groupe de threads persistants pour les boucles parallèles répétées.
+
+ Les méthodes itératives (sous-gradient, coordination des stations)
+ relancent le même travail parallèle des centaines de fois : créer et
+ joindre des threads à chaque tour coûte plus que le travail sur les petites
+ instances, et chaque nouveau thread recrée son environnement CPLEX. Les
+ threads d'un Worker_Pool sont créés une fois et attendent le tour suivant.
+
+ run(nb_tasks, task) exécute task(0) .. task(nb_tasks - 1), distribuées à
+ la demande, et ne rend la main que lorsque toutes sont terminées : c'est la
+ barrière entre deux tours. Le thread appelant participe au travail. La
+ première exception levée par une tâche arrête la distribution et est
+ relancée par run.
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Worker_Pool {
+public:
+    // nb_threads en comptant l'appelant (0 = nombre de coeurs) ; 1 : tout
+    // s'exécute dans le thread appelant
+    explicit Worker_Pool(int nb_threads);
+    ~Worker_Pool();
+
+    Worker_Pool(const Worker_Pool&) = delete;
+    Worker_Pool& operator=(const Worker_Pool&) = delete;
+
+    int size() const { return (int) workers.size() + 1; }
+
+    void run(int nb_tasks, const std::function<void(int)>& task);
+
+private:
+    void work();
+    void loop();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable start;      // nouveau tour ou arrêt
+    std::condition_variable done;       // tous les threads ont fini le tour
+
+    // Tour courant, protégé par mutex sauf next et failed
+    const std::function<void(int)>* task = nullptr;
+    int nb_tasks = 0;
+    long generation = 0;
+    int nb_busy = 0;
+    bool stop = false;
+    std::atomic<int> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+};
+
+#endif